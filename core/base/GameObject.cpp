@@ -1,6 +1,7 @@
 #include "GameObject.h"
 #include "..\lib\collection_types.h"
 #include "Assert.h"
+#include "..\jobs\FrameGraph.h"
 
 namespace ds {
 
@@ -46,6 +47,14 @@ namespace ds {
 			}
 		}
 
+		static void tickGameObjects(void* data, float dt) {
+			update_game_objects(dt);
+		}
+
+		int add_task(FrameGraph* graph) {
+			return graph->add("UPDATE::GameObjects", tickGameObjects, 0, FTF_MAIN_THREAD);
+		}
+
 		void render_game_objects() {
 			XASSERT(_goCtx != 0, "No GameObjectContext");
 			for (uint32_t i = 0; i < _goCtx->objects.size(); ++i) {
@@ -4,6 +4,8 @@
 
 namespace ds {
 
+	class FrameGraph;
+
 	class GameObject : public StateObject {
 
 	public:
@@ -34,6 +36,8 @@ namespace ds {
 
 		void update_game_objects(float dt);
 
+		int add_task(FrameGraph* graph);
+
 		void render_game_objects();
 
 		void activate_game_object(const StaticHash& hash);
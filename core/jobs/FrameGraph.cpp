@@ -0,0 +1,130 @@
+#include "FrameGraph.h"
+#include "JobSystem.h"
+#include "..\base\Assert.h"
+#include "..\profiler\Profiler.h"
+#include <chrono>
+#include <thread>
+
+namespace ds {
+
+	FrameGraph::FrameGraph(JobSystem* jobs) : _jobs(jobs), _numTasks(0), _dt(0.0f), _remaining(0), _mainHead(0), _mainTail(0) {
+	}
+
+	// -----------------------------------------------
+	// add task
+	// -----------------------------------------------
+	int FrameGraph::add(const char* name, FrameTaskFunction function, void* data, int flags) {
+		XASSERT(_numTasks < MAX_FRAME_TASKS, "Too many tasks in frame graph");
+		FrameTask& t = _tasks[_numTasks];
+		t.name = name;
+		t.function = function;
+		t.data = data;
+		t.flags = flags;
+		t.numDependencies = 0;
+		t.dependents = 0;
+		t.pending = 0;
+		t.time = 0.0f;
+		return _numTasks++;
+	}
+
+	// -----------------------------------------------
+	// task depends on dependency
+	// -----------------------------------------------
+	void FrameGraph::dependsOn(int task, int dependency) {
+		XASSERT(dependency < task, "A task can only depend on tasks added before");
+		uint64_t bit = (uint64_t)1 << task;
+		FrameTask& d = _tasks[dependency];
+		if ((d.dependents & bit) == 0) {
+			d.dependents |= bit;
+			++_tasks[task].numDependencies;
+		}
+	}
+
+	void FrameGraph::clear() {
+		_numTasks = 0;
+	}
+
+	// -----------------------------------------------
+	// tick - run all tasks and help with jobs until 
+	// every task is done
+	// -----------------------------------------------
+	void FrameGraph::tick(float dt) {
+		ZoneTracker z("FrameGraph::tick");
+		_dt = dt;
+		_mainHead = 0;
+		_mainTail = 0;
+		_remaining = _numTasks;
+		for (int i = 0; i < _numTasks; ++i) {
+			_tasks[i].pending = _tasks[i].numDependencies;
+		}
+		for (int i = 0; i < _numTasks; ++i) {
+			if (_tasks[i].numDependencies == 0) {
+				schedule(i);
+			}
+		}
+		while (_remaining > 0) {
+			int task = -1;
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (_mainHead < _mainTail) {
+					task = _mainQueue[_mainHead++];
+				}
+			}
+			if (task != -1) {
+				execute(task);
+			}
+			else if (_jobs == 0 || !_jobs->runOne()) {
+				std::this_thread::yield();
+			}
+		}
+		for (int i = 0; i < _numTasks; ++i) {
+			if (_tasks[i].function != 0) {
+				perf::addTimerValue(_tasks[i].name, _tasks[i].time);
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// schedule task whose dependencies are all done
+	// -----------------------------------------------
+	void FrameGraph::schedule(int task) {
+		const FrameTask& t = _tasks[task];
+		if (_jobs == 0 || t.function == 0 || (t.flags & FTF_MAIN_THREAD) != 0) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			_mainQueue[_mainTail++] = task;
+		}
+		else {
+			_jobs->run(runJob, this, task, task + 1, 0);
+		}
+	}
+
+	void FrameGraph::runJob(void* data, int start, int end) {
+		FrameGraph* graph = (FrameGraph*)data;
+		graph->execute(start);
+	}
+
+	// -----------------------------------------------
+	// execute task and release its dependents
+	// -----------------------------------------------
+	void FrameGraph::execute(int task) {
+		FrameTask& t = _tasks[task];
+		if (t.function != 0) {
+			std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+			t.function(t.data, _dt);
+			std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+			t.time = elapsed.count();
+		}
+		uint64_t dependents = t.dependents;
+		for (int i = task + 1; i < _numTasks && dependents != 0; ++i) {
+			uint64_t bit = (uint64_t)1 << i;
+			if ((dependents & bit) != 0) {
+				dependents &= ~bit;
+				if (--_tasks[i].pending == 0) {
+					schedule(i);
+				}
+			}
+		}
+		--_remaining;
+	}
+
+}
\ No newline at end of file
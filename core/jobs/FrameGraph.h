@@ -0,0 +1,71 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+namespace ds {
+
+	class JobSystem;
+
+	// one bit per task in the dependents mask
+	const int MAX_FRAME_TASKS = 64;
+
+	typedef void(*FrameTaskFunction)(void* data, float dt);
+
+	enum FrameTaskFlags {
+		FTF_NONE = 0,
+		FTF_MAIN_THREAD = 1
+	};
+
+	struct FrameTask {
+		const char* name;
+		FrameTaskFunction function;
+		void* data;
+		int flags;
+		int numDependencies;
+		uint64_t dependents;
+		std::atomic<int> pending;
+		float time;
+	};
+
+	// -----------------------------------------------
+	// FrameGraph - the tasks of a frame and their
+	// dependencies. A task may only depend on tasks 
+	// added before it. Tasks without FTF_MAIN_THREAD 
+	// run on the job system as soon as all their
+	// dependencies are done, main thread tasks run on
+	// the thread calling tick. A task without function
+	// can be used to join a group of tasks. The time
+	// of every task is added to the profiler.
+	// -----------------------------------------------
+	class FrameGraph {
+
+	public:
+		FrameGraph(JobSystem* jobs);
+		~FrameGraph() {}
+		int add(const char* name, FrameTaskFunction function, void* data, int flags = FTF_NONE);
+		void dependsOn(int task, int dependency);
+		void tick(float dt);
+		void clear();
+		int size() const {
+			return _numTasks;
+		}
+		float getTime(int task) const {
+			return _tasks[task].time;
+		}
+	private:
+		static void runJob(void* data, int start, int end);
+		void schedule(int task);
+		void execute(int task);
+		JobSystem* _jobs;
+		FrameTask _tasks[MAX_FRAME_TASKS];
+		int _numTasks;
+		float _dt;
+		std::atomic<int> _remaining;
+		std::mutex _mutex;
+		int _mainQueue[MAX_FRAME_TASKS];
+		int _mainHead;
+		int _mainTail;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,307 @@
+#include "JobSystem.h"
+#include <assert.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <stdio.h>
+#endif
+
+namespace ds {
+
+	// index of the context of the current thread
+	static thread_local int gJobThread = -1;
+	// system the current thread belongs to
+	static thread_local JobSystem* gJobSystem = 0;
+
+	// -----------------------------------------------
+	// JobQueue
+	// -----------------------------------------------
+	void JobQueue::push(Job* job) {
+		int b = _bottom.load(std::memory_order_relaxed);
+		assert(b - _top.load(std::memory_order_relaxed) < MAX_JOBS);
+		_jobs[b & (MAX_JOBS - 1)].store(job, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		_bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	Job* JobQueue::pop() {
+		int b = _bottom.load(std::memory_order_relaxed) - 1;
+		_bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int t = _top.load(std::memory_order_relaxed);
+		if (t <= b) {
+			Job* job = _jobs[b & (MAX_JOBS - 1)].load(std::memory_order_relaxed);
+			if (t == b) {
+				// last job - race against the thieves
+				if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+					job = 0;
+				}
+				_bottom.store(b + 1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+		_bottom.store(b + 1, std::memory_order_relaxed);
+		return 0;
+	}
+
+	Job* JobQueue::steal() {
+		int t = _top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int b = _bottom.load(std::memory_order_acquire);
+		if (t < b) {
+			Job* job = _jobs[t & (MAX_JOBS - 1)].load(std::memory_order_relaxed);
+			if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				return 0;
+			}
+			return job;
+		}
+		return 0;
+	}
+
+	// -----------------------------------------------
+	// JobSystem - context 0 belongs to the creating 
+	// thread and context i + 1 to worker i
+	// -----------------------------------------------
+	JobSystem::JobSystem(int workers) : _pending(0), _sleeping(0), _stop(false) {
+		if (workers < 0) {
+			workers = getNumCores() - 1;
+		}
+		for (int i = 0; i <= workers; ++i) {
+			ThreadContext* ctx = new ThreadContext;
+			ctx->allocated = 0;
+			ctx->seed = 2166136261u + i * 16777619u;
+			_contexts.push_back(ctx);
+		}
+		gJobThread = 0;
+		gJobSystem = this;
+		for (int i = 0; i < workers; ++i) {
+			_threads.push_back(std::thread(&JobSystem::work, this, i + 1));
+		}
+	}
+
+	JobSystem::~JobSystem() {
+		_stop = true;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_wakeup.notify_all();
+		}
+		for (size_t i = 0; i < _threads.size(); ++i) {
+			_threads[i].join();
+		}
+		for (size_t i = 0; i < _contexts.size(); ++i) {
+			delete _contexts[i];
+		}
+		if (gJobSystem == this) {
+			gJobSystem = 0;
+			gJobThread = -1;
+		}
+	}
+
+#ifndef _WIN32
+	const int MAX_CPUS = 1024;
+
+	static bool readTopology(int cpu, const char* name, int* value) {
+		char path[128];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, name);
+		FILE* f = fopen(path, "r");
+		if (f == 0) {
+			return false;
+		}
+		bool ret = fscanf(f, "%d", value) == 1;
+		fclose(f);
+		return ret;
+	}
+#endif
+
+	// -----------------------------------------------
+	// number of physical cores - on Linux the distinct
+	// (package, core) pairs of the online cpus. Falls
+	// back to the logical cores if the topology is
+	// not available.
+	// -----------------------------------------------
+	int JobSystem::getNumCores() {
+		int cores = 0;
+#ifdef _WIN32
+		DWORD length = 0;
+		GetLogicalProcessorInformation(0, &length);
+		if (length > 0) {
+			SYSTEM_LOGICAL_PROCESSOR_INFORMATION* info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION*)malloc(length);
+			if (GetLogicalProcessorInformation(info, &length)) {
+				int num = length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+				for (int i = 0; i < num; ++i) {
+					if (info[i].Relationship == RelationProcessorCore) {
+						++cores;
+					}
+				}
+			}
+			free(info);
+		}
+#else
+		static int keys[MAX_CPUS];
+		for (int i = 0; i < MAX_CPUS; ++i) {
+			int package = 0;
+			int core = 0;
+			if (!readTopology(i, "physical_package_id", &package) || !readTopology(i, "core_id", &core)) {
+				continue;
+			}
+			int key = (package << 16) | (core & 0xffff);
+			bool found = false;
+			for (int j = 0; j < cores && !found; ++j) {
+				found = keys[j] == key;
+			}
+			if (!found) {
+				keys[cores++] = key;
+			}
+		}
+#endif
+		if (cores == 0) {
+			cores = (int)std::thread::hardware_concurrency();
+		}
+		return cores > 0 ? cores : 1;
+	}
+
+	JobSystem::ThreadContext* JobSystem::context() {
+		assert(gJobSystem == this && gJobThread != -1);
+		return _contexts[gJobThread];
+	}
+
+	// -----------------------------------------------
+	// allocate job from the ring buffer of the thread
+	// -----------------------------------------------
+	Job* JobSystem::allocate(ThreadContext* ctx) {
+		Job* job = &ctx->jobs[ctx->allocated & (MAX_JOBS - 1)];
+		++ctx->allocated;
+		return job;
+	}
+
+	void JobSystem::submit(JobFunction function, void* data, int start, int end, int grain, JobCounter* counter) {
+		ThreadContext* ctx = context();
+		Job* job = allocate(ctx);
+		job->function = function;
+		job->data = data;
+		job->start = start;
+		job->end = end;
+		job->grain = grain;
+		job->counter = counter;
+		if (counter != 0) {
+			++counter->value;
+		}
+		ctx->queue.push(job);
+		++_pending;
+		if (_sleeping > 0) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			_wakeup.notify_one();
+		}
+	}
+
+	// -----------------------------------------------
+	// run single job
+	// -----------------------------------------------
+	void JobSystem::run(JobFunction function, void* data, JobCounter* counter) {
+		submit(function, data, 0, 1, 1, counter);
+	}
+
+	void JobSystem::run(JobFunction function, void* data, int start, int end, JobCounter* counter) {
+		submit(function, data, start, end, end - start, counter);
+	}
+
+	// -----------------------------------------------
+	// parallel for - the range is split in halves
+	// while it is larger than the grain size
+	// -----------------------------------------------
+	void JobSystem::parallel_for(int start, int end, int grain, JobFunction function, void* data, JobCounter* counter) {
+		if (end <= start) {
+			return;
+		}
+		if (grain < 1) {
+			grain = 1;
+		}
+		submit(function, data, start, end, grain, counter);
+	}
+
+	// -----------------------------------------------
+	// next - pop from the own queue or steal from
+	// a random victim
+	// -----------------------------------------------
+	Job* JobSystem::next(ThreadContext* ctx) {
+		Job* job = ctx->queue.pop();
+		if (job == 0) {
+			int num = (int)_contexts.size();
+			ctx->seed = ctx->seed * 1664525u + 1013904223u;
+			int first = (int)((ctx->seed >> 8) % num);
+			for (int i = 0; i < num && job == 0; ++i) {
+				ThreadContext* victim = _contexts[(first + i) % num];
+				if (victim != ctx) {
+					job = victim->queue.steal();
+				}
+			}
+		}
+		if (job != 0) {
+			--_pending;
+		}
+		return job;
+	}
+
+	void JobSystem::execute(Job* job) {
+		// the slot might be reused by the owner while running
+		Job current = *job;
+		while (current.end - current.start > current.grain) {
+			int mid = current.start + (current.end - current.start) / 2;
+			submit(current.function, current.data, mid, current.end, current.grain, current.counter);
+			current.end = mid;
+		}
+		current.function(current.data, current.start, current.end);
+		if (current.counter != 0) {
+			--current.counter->value;
+		}
+	}
+
+	// -----------------------------------------------
+	// wait - execute jobs until the counter is done
+	// -----------------------------------------------
+	void JobSystem::wait(JobCounter* counter) {
+		while (!counter->isDone()) {
+			if (!runOne()) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool JobSystem::runOne() {
+		Job* job = next(context());
+		if (job != 0) {
+			execute(job);
+			return true;
+		}
+		return false;
+	}
+
+	// -----------------------------------------------
+	// worker
+	// -----------------------------------------------
+	void JobSystem::work(int index) {
+		gJobThread = index;
+		gJobSystem = this;
+		ThreadContext* ctx = _contexts[index];
+		int idle = 0;
+		while (!_stop) {
+			Job* job = next(ctx);
+			if (job != 0) {
+				execute(job);
+				idle = 0;
+			}
+			else if (++idle < 64) {
+				std::this_thread::yield();
+			}
+			else {
+				std::unique_lock<std::mutex> lock(_mutex);
+				++_sleeping;
+				_wakeup.wait(lock, [this] { return _stop || _pending > 0; });
+				--_sleeping;
+				idle = 0;
+			}
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+namespace ds {
+
+	// maximum number of jobs in flight per thread - must be a power of two
+	const int MAX_JOBS = 4096;
+
+	typedef void(*JobFunction)(void* data, int start, int end);
+
+	// -----------------------------------------------
+	// JobCounter - counts the unfinished jobs of a
+	// batch. Pass it to run / parallel_for and wait 
+	// on it.
+	// -----------------------------------------------
+	struct JobCounter {
+
+		std::atomic<int> value;
+
+		JobCounter() : value(0) {}
+
+		bool isDone() const {
+			return value == 0;
+		}
+	};
+
+	struct Job {
+		JobFunction function;
+		void* data;
+		int start;
+		int end;
+		int grain;
+		JobCounter* counter;
+	};
+
+	// -----------------------------------------------
+	// JobQueue - Chase-Lev deque. The owning thread 
+	// pushes and pops at the bottom, all other threads
+	// steal from the top.
+	// -----------------------------------------------
+	class JobQueue {
+
+	public:
+		JobQueue() : _top(0), _bottom(0) {
+			for (int i = 0; i < MAX_JOBS; ++i) {
+				_jobs[i] = 0;
+			}
+		}
+		void push(Job* job);
+		Job* pop();
+		Job* steal();
+		int size() const {
+			return _bottom - _top;
+		}
+	private:
+		std::atomic<int> _top;
+		std::atomic<int> _bottom;
+		std::atomic<Job*> _jobs[MAX_JOBS];
+	};
+
+	// -----------------------------------------------
+	// JobSystem - fixed pool of workers with work 
+	// stealing. Jobs can be submitted from the thread
+	// that created the system and from jobs running on
+	// the workers. The waiting thread executes jobs 
+	// until the counter reaches zero.
+	// -----------------------------------------------
+	class JobSystem {
+
+	public:
+		JobSystem(int workers = -1);
+		~JobSystem();
+		void run(JobFunction function, void* data, JobCounter* counter);
+		void run(JobFunction function, void* data, int start, int end, JobCounter* counter);
+		void parallel_for(int start, int end, int grain, JobFunction function, void* data, JobCounter* counter);
+		void wait(JobCounter* counter);
+		// executes one pending job - returns false if there was none
+		bool runOne();
+		int getNumWorkers() const {
+			return (int)_threads.size();
+		}
+		static int getNumCores();
+	private:
+		struct ThreadContext {
+			JobQueue queue;
+			Job jobs[MAX_JOBS];
+			uint32_t allocated;
+			uint32_t seed;
+		};
+		ThreadContext* context();
+		Job* allocate(ThreadContext* ctx);
+		void submit(JobFunction function, void* data, int start, int end, int grain, JobCounter* counter);
+		Job* next(ThreadContext* ctx);
+		void execute(Job* job);
+		void work(int index);
+		std::vector<ThreadContext*> _contexts;
+		std::vector<std::thread> _threads;
+		std::mutex _mutex;
+		std::condition_variable _wakeup;
+		std::atomic<int> _pending;
+		std::atomic<int> _sleeping;
+		std::atomic<bool> _stop;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "ArchetypeStorage.h"
+#include "..\memory\DefaultAllocator.h"
+#include "..\base\Assert.h"
+#include <string.h>
+
+namespace ds {
+
+	ArchetypeStorage::ArchetypeStorage() : _numChannels(0), _numArchetypes(0), _size(0) {
+		for (int i = 0; i < MAX_ARCHETYPES; ++i) {
+			_archetypes[i] = 0;
+		}
+	}
+
+	ArchetypeStorage::~ArchetypeStorage() {
+		for (int i = 0; i < _numArchetypes; ++i) {
+			Archetype* a = _archetypes[i];
+			for (uint32_t j = 0; j < a->chunks.size(); ++j) {
+				DEALLOC(a->chunks[j]->data);
+				DEALLOC(a->chunks[j]);
+			}
+			delete a;
+		}
+	}
+
+	// -----------------------------------------------
+	// init - the sizes of all possible components
+	// -----------------------------------------------
+	void ArchetypeStorage::init(int* sizes, int num) {
+		assert(num < MAX_BLOCKS);
+		XASSERT(_size == 0, "The storage must be empty");
+		for (int i = 0; i < num; ++i) {
+			_sizes[i] = sizes[i];
+		}
+		_numChannels = num;
+	}
+
+	// -----------------------------------------------
+	// add channel - the existing archetypes do not 
+	// contain it so no chunk has to change
+	// -----------------------------------------------
+	int ArchetypeStorage::addChannel(int size) {
+		XASSERT(_numChannels < MAX_BLOCKS, "Too many components");
+		_sizes[_numChannels] = size;
+		return _numChannels++;
+	}
+
+	// -----------------------------------------------
+	// find archetype - creates a new one when there
+	// is no archetype with this mask yet
+	// -----------------------------------------------
+	int ArchetypeStorage::findArchetype(uint32_t components) {
+		for (int i = 0; i < _numArchetypes; ++i) {
+			if (_archetypes[i]->mask == components) {
+				return i;
+			}
+		}
+		XASSERT(_numArchetypes < MAX_ARCHETYPES, "Too many archetypes");
+		int rowSize = sizeof(ID);
+		int columns = 1;
+		for (int i = 0; i < _numChannels; ++i) {
+			if ((components & (1 << i)) != 0) {
+				rowSize += _sizes[i];
+				++columns;
+			}
+		}
+		Archetype* a = new Archetype;
+		a->mask = components;
+		// leave room to align every column
+		a->capacity = (ARCHETYPE_CHUNK_SIZE - columns * ARCHETYPE_COLUMN_ALIGNMENT) / rowSize;
+		XASSERT(a->capacity > 0, "The components do not fit into one chunk");
+		_archetypes[_numArchetypes] = a;
+		return _numArchetypes++;
+	}
+
+	// -----------------------------------------------
+	// create chunk - the ids are the first column
+	// -----------------------------------------------
+	ArchetypeChunk* ArchetypeStorage::createChunk(const Archetype* archetype) {
+		ArchetypeChunk* chunk = (ArchetypeChunk*)ALLOC(sizeof(ArchetypeChunk));
+		chunk->data = (char*)ALLOC(ARCHETYPE_CHUNK_SIZE);
+		chunk->size = 0;
+		chunk->capacity = archetype->capacity;
+		char* p = (char*)memory::align_forward(chunk->data, ARCHETYPE_COLUMN_ALIGNMENT);
+		chunk->ids = (ID*)p;
+		p += chunk->capacity * sizeof(ID);
+		for (int i = 0; i < MAX_BLOCKS; ++i) {
+			chunk->columns[i] = 0;
+			if (i < _numChannels && (archetype->mask & (1 << i)) != 0) {
+				p = (char*)memory::align_forward(p, ARCHETYPE_COLUMN_ALIGNMENT);
+				chunk->columns[i] = p;
+				p += chunk->capacity * _sizes[i];
+			}
+		}
+		assert(p <= chunk->data + ARCHETYPE_CHUNK_SIZE);
+		return chunk;
+	}
+
+	// -----------------------------------------------
+	// allocate - appends a zeroed row to the last chunk
+	// -----------------------------------------------
+	ArchetypeStorage::Location ArchetypeStorage::allocate(int archetype, ID id) {
+		Archetype* a = _archetypes[archetype];
+		if (a->chunks.size() == 0 || a->chunks[a->chunks.size() - 1]->size == a->capacity) {
+			a->chunks.push_back(createChunk(a));
+		}
+		ArchetypeChunk* chunk = a->chunks[a->chunks.size() - 1];
+		Location location;
+		location.archetype = archetype;
+		location.chunk = a->chunks.size() - 1;
+		location.row = chunk->size++;
+		chunk->ids[location.row] = id;
+		for (int i = 0; i < _numChannels; ++i) {
+			if (chunk->columns[i] != 0) {
+				memset(chunk->columns[i] + location.row * _sizes[i], 0, _sizes[i]);
+			}
+		}
+		return location;
+	}
+
+	// -----------------------------------------------
+	// release - moves the last row of the archetype
+	// into the free row and drops empty chunks
+	// -----------------------------------------------
+	void ArchetypeStorage::release(const Location& location) {
+		Archetype* a = _archetypes[location.archetype];
+		ArchetypeChunk* chunk = a->chunks[location.chunk];
+		int lastChunk = a->chunks.size() - 1;
+		ArchetypeChunk* last = a->chunks[lastChunk];
+		int lastRow = last->size - 1;
+		if (chunk != last || location.row != lastRow) {
+			for (int i = 0; i < _numChannels; ++i) {
+				if (chunk->columns[i] != 0) {
+					memcpy(chunk->columns[i] + location.row * _sizes[i], last->columns[i] + lastRow * _sizes[i], _sizes[i]);
+				}
+			}
+			ID moved = last->ids[lastRow];
+			chunk->ids[location.row] = moved;
+			Location& l = _locations[moved & INDEX_MASK];
+			l.chunk = location.chunk;
+			l.row = location.row;
+		}
+		--last->size;
+		if (last->size == 0) {
+			DEALLOC(last->data);
+			DEALLOC(last);
+			a->chunks.pop_back();
+		}
+	}
+
+	// -----------------------------------------------
+	// add - the entity must not be part of the storage
+	// -----------------------------------------------
+	void ArchetypeStorage::add(ID id, uint32_t components) {
+		XASSERT(!contains(id), "Entity %d is already stored", id);
+		uint32_t idx = id & INDEX_MASK;
+		while (_locations.size() <= idx) {
+			Location location;
+			location.archetype = -1;
+			location.chunk = 0;
+			location.row = 0;
+			_locations.push_back(location);
+		}
+		_locations[idx] = allocate(findArchetype(components), id);
+		++_size;
+	}
+
+	// -----------------------------------------------
+	// remove
+	// -----------------------------------------------
+	void ArchetypeStorage::remove(ID id) {
+		XASSERT(contains(id), "Invalid id %d", id);
+		Location& location = _locations[id & INDEX_MASK];
+		release(location);
+		location.archetype = -1;
+		--_size;
+	}
+
+	bool ArchetypeStorage::contains(ID id) const {
+		uint32_t idx = id & INDEX_MASK;
+		return idx < _locations.size() && _locations[idx].archetype != -1;
+	}
+
+	// -----------------------------------------------
+	// move - copies all shared components into the
+	// new archetype
+	// -----------------------------------------------
+	void ArchetypeStorage::move(ID id, uint32_t components) {
+		XASSERT(contains(id), "Invalid id %d", id);
+		Location current = _locations[id & INDEX_MASK];
+		if (_archetypes[current.archetype]->mask == components) {
+			return;
+		}
+		Location next = allocate(findArchetype(components), id);
+		ArchetypeChunk* src = _archetypes[current.archetype]->chunks[current.chunk];
+		ArchetypeChunk* dst = _archetypes[next.archetype]->chunks[next.chunk];
+		for (int i = 0; i < _numChannels; ++i) {
+			if (src->columns[i] != 0 && dst->columns[i] != 0) {
+				memcpy(dst->columns[i] + next.row * _sizes[i], src->columns[i] + current.row * _sizes[i], _sizes[i]);
+			}
+		}
+		_locations[id & INDEX_MASK] = next;
+		release(current);
+	}
+
+	void ArchetypeStorage::addComponents(ID id, uint32_t components) {
+		move(id, getComponents(id) | components);
+	}
+
+	void ArchetypeStorage::removeComponents(ID id, uint32_t components) {
+		move(id, getComponents(id) & ~components);
+	}
+
+	uint32_t ArchetypeStorage::getComponents(ID id) const {
+		XASSERT(contains(id), "Invalid id %d", id);
+		return _archetypes[_locations[id & INDEX_MASK].archetype]->mask;
+	}
+
+	bool ArchetypeStorage::has(ID id, int channel) const {
+		return (getComponents(id) & (1 << channel)) != 0;
+	}
+
+	// -----------------------------------------------
+	// query - returns the number of chunks
+	// -----------------------------------------------
+	int ArchetypeStorage::query(uint32_t components, ArchetypeChunk** chunks, int max) const {
+		int cnt = 0;
+		for (int i = 0; i < _numArchetypes; ++i) {
+			const Archetype* a = _archetypes[i];
+			if ((a->mask & components) == components) {
+				for (uint32_t j = 0; j < a->chunks.size() && cnt < max; ++j) {
+					chunks[cnt++] = a->chunks[j];
+				}
+			}
+		}
+		return cnt;
+	}
+
+	void* ArchetypeStorage::get_ptr(ID id, int channel) {
+		XASSERT(has(id, channel), "Entity %d has no component %d", id, channel);
+		const Location& location = _locations[id & INDEX_MASK];
+		ArchetypeChunk* chunk = _archetypes[location.archetype]->chunks[location.chunk];
+		return chunk->columns[channel] + location.row * _sizes[channel];
+	}
+
+	const void* ArchetypeStorage::get_ptr(ID id, int channel) const {
+		XASSERT(has(id, channel), "Entity %d has no component %d", id, channel);
+		const Location& location = _locations[id & INDEX_MASK];
+		const ArchetypeChunk* chunk = _archetypes[location.archetype]->chunks[location.chunk];
+		return chunk->columns[channel] + location.row * _sizes[channel];
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+#include "..\Common.h"
+#include "collection_types.h"
+#include "BlockArray.h"
+
+namespace ds {
+
+	const int ARCHETYPE_CHUNK_SIZE = 16 * 1024;
+	const int ARCHETYPE_COLUMN_ALIGNMENT = 16;
+	const int MAX_ARCHETYPES = 64;
+
+	// -----------------------------------------------
+	// ArchetypeChunk - one 16 KB block of entities 
+	// sharing the same set of components. Every 
+	// component is a column (SoA) and the rows are
+	// always dense.
+	// -----------------------------------------------
+	struct ArchetypeChunk {
+		char* data;
+		ID* ids;
+		char* columns[MAX_BLOCKS];
+		int size;
+		int capacity;
+
+		template<class T>
+		T* get(int channel) {
+			return (T*)columns[channel];
+		}
+
+		template<class T>
+		const T* get(int channel) const {
+			return (const T*)columns[channel];
+		}
+	};
+
+	// -----------------------------------------------
+	// ArchetypeStorage
+	//
+	// Entities are grouped by their component mask.
+	// Adding or removing a component moves the entity
+	// into the chunk of the matching archetype. Every
+	// archetype keeps its chunks full except for the
+	// last one so removing swaps in the very last row.
+	// The IDs are given by the caller so the storage
+	// can hold the components of entities living in
+	// a ChannelArray (see WS_ARCHETYPE). Components 
+	// can be added at any time by addChannel.
+	// -----------------------------------------------
+	class ArchetypeStorage {
+
+		struct Archetype {
+			uint32_t mask;
+			int capacity;
+			Array<ArchetypeChunk*> chunks;
+		};
+
+		struct Location {
+			int archetype;
+			int chunk;
+			int row;
+		};
+
+	public:
+		ArchetypeStorage();
+		~ArchetypeStorage();
+		void init(int* sizes, int num);
+		// appends a component and returns its index
+		int addChannel(int size);
+		void add(ID id, uint32_t components);
+		void remove(ID id);
+		bool contains(ID id) const;
+		void addComponents(ID id, uint32_t components);
+		void removeComponents(ID id, uint32_t components);
+		uint32_t getComponents(ID id) const;
+		bool has(ID id, int channel) const;
+		// all chunks whose archetype contains every component of the mask
+		int query(uint32_t components, ArchetypeChunk** chunks, int max) const;
+		uint32_t size() const {
+			return _size;
+		}
+		uint32_t numArchetypes() const {
+			return _numArchetypes;
+		}
+		uint32_t getMask(int archetype) const {
+			return _archetypes[archetype]->mask;
+		}
+		int numChunks(int archetype) const {
+			return _archetypes[archetype]->chunks.size();
+		}
+		ArchetypeChunk* getChunk(int archetype, int chunk) const {
+			return _archetypes[archetype]->chunks[chunk];
+		}
+
+		template<class T>
+		void set(ID id, int channel, const T& t) {
+			*(T*)get_ptr(id, channel) = t;
+		}
+
+		template<class T>
+		T& get(ID id, int channel) {
+			return *(T*)get_ptr(id, channel);
+		}
+
+		template<class T>
+		const T& get(ID id, int channel) const {
+			return *(const T*)get_ptr(id, channel);
+		}
+
+		void* get_ptr(ID id, int channel);
+		const void* get_ptr(ID id, int channel) const;
+	private:
+		int findArchetype(uint32_t components);
+		ArchetypeChunk* createChunk(const Archetype* archetype);
+		Location allocate(int archetype, ID id);
+		void release(const Location& location);
+		void move(ID id, uint32_t components);
+		int _sizes[MAX_BLOCKS];
+		int _numChannels;
+		Archetype* _archetypes[MAX_ARCHETYPES];
+		int _numArchetypes;
+		// entity index -> location
+		Array<Location> _locations;
+		uint32_t _size;
+	};
+
+}
\ No newline at end of file
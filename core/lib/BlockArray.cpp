@@ -74,6 +74,32 @@ void BlockArray::swap(int newIndex,int oldIndex) {
 	}
 }
 
+// --------------------------------------------------------
+// permute - reorders all rows so that the new row i is
+// the old row order[i]
+// --------------------------------------------------------
+void BlockArray::permute(const int* order) {
+	if (size < 2) {
+		return;
+	}
+	int max = 0;
+	for (int i = 0; i < _num_blocks; ++i) {
+		if (_sizes[i] > max) {
+			max = _sizes[i];
+		}
+	}
+	char* t = (char*)ALLOC(size * max);
+	for (int i = 0; i < _num_blocks; ++i) {
+		char* block = data + _indices[i];
+		int s = _sizes[i];
+		for (uint32_t j = 0; j < size; ++j) {
+			memcpy(t + j * s, block + order[j] * s, s);
+		}
+		memcpy(block, t, size * s);
+	}
+	DEALLOC(t);
+}
+
 namespace ds {
 
 	// --------------------------------------------------------
@@ -257,41 +283,51 @@ namespace ds {
 	// ChannelArray
 	// --------------------------------------------------------
 
-	ChannelArray::ChannelArray() : size(0), capacity(0), data(0), total_capacity(0), _sparse(0) {
+	ChannelArray::ChannelArray() : size(0), awake(0), capacity(0), data(0), cold(0), total_capacity(0), _cold(0), _sparse(0), _dense(0), _hot(0), textures(0) {
 	}
 
 
 	ChannelArray::~ChannelArray() {
-		if (data != 0) {
-			DEALLOC(data);
+		if (_hot != 0) {
+			DEALLOC(_hot);
+		}
+		if (cold != 0) {
+			DEALLOC(cold);
 		}
 		if (_sparse != 0) {
 			DEALLOC(_sparse);
 		}
+		if (_dense != 0) {
+			DEALLOC(_dense);
+		}
 	}
 
 	// -----------------------------------------------
 	// init by channel types
 	// -----------------------------------------------
-	void ChannelArray::init(ChannelType* types, int num) {
+	void ChannelArray::init(ChannelType* types, int num, uint32_t coldChannels) {
 		assert(num < MAX_BLOCKS);
+		assert(data == 0);
 		for (int i = 0; i < num; ++i) {
 			const ChannelDefinition& def = CHANNEL_DEFINITIONS[types[i]];
 			_sizes[i] = def.size;
 			_types[i] = def.type;
 		}
 		_num_blocks = num;
+		_cold = coldChannels;
 	}
 
 	// -----------------------------------------------
 	// init
 	// -----------------------------------------------
-	void ChannelArray::init(int* sizes, int num) {
+	void ChannelArray::init(int* sizes, int num, uint32_t coldChannels) {
 		assert(num < MAX_BLOCKS);
+		assert(data == 0);
 		for (int i = 0; i < num; ++i) {
 			_sizes[i] = sizes[i];
 		}
 		_num_blocks = num;
+		_cold = coldChannels;
 	}
 
 	int ChannelArray::find_free() const {
@@ -303,62 +339,189 @@ namespace ds {
 		return -1;
 	}
 	// -----------------------------------------------
-	// add
+	// add - the IDs behind size in the dense array
+	// are the free ones. The hot row and the cold row
+	// of the ID are cleared and the new entity is
+	// swapped with the first sleeping one so it 
+	// starts awake.
 	// -----------------------------------------------
 	ID ChannelArray::add() {
 		if (size + 1 > capacity) {
 			resize(size * 2 + 8);
 		}
-		int idx = find_free();
+		int idx = _dense[size];
+		for (int i = 0; i < _num_blocks; ++i) {
+			if (isCold(i)) {
+				memset(cold + _indices[i] + idx * _sizes[i], 0, _sizes[i]);
+			}
+			else {
+				memset(data + _indices[i] + size * _sizes[i], 0, _sizes[i]);
+			}
+		}
 		_sparse[idx] = size++;
+		if (awake < size - 1) {
+			swap(awake, size - 1);
+		}
+		++awake;
 		return idx;
 	}
 
+	// -----------------------------------------------
+	// swap - exchanges two dense rows
+	// -----------------------------------------------
+	void ChannelArray::swap(int first, int second) {
+		if (first == second) {
+			return;
+		}
+		char tmp[64];
+		for (int i = 0; i < _num_blocks; ++i) {
+			if (isCold(i)) {
+				continue;
+			}
+			char* f = data + _indices[i] + first * _sizes[i];
+			char* s = data + _indices[i] + second * _sizes[i];
+			for (int j = 0; j < _sizes[i]; j += 64) {
+				int n = _sizes[i] - j < 64 ? _sizes[i] - j : 64;
+				memcpy(tmp, f + j, n);
+				memcpy(f + j, s + j, n);
+				memcpy(s + j, tmp, n);
+			}
+		}
+		int fid = _dense[first];
+		int sid = _dense[second];
+		_dense[first] = sid;
+		_dense[second] = fid;
+		_sparse[sid] = first;
+		_sparse[fid] = second;
+	}
+
+	// -----------------------------------------------
+	// wake - moves the entity to the end of the awake
+	// rows
+	// -----------------------------------------------
+	void ChannelArray::wake(ID id) {
+		int index = _sparse[id & INDEX_MASK];
+		if (index >= awake) {
+			swap(index, awake);
+			++awake;
+		}
+	}
+
+	// -----------------------------------------------
+	// sleep - moves the entity to the start of the 
+	// sleeping rows
+	// -----------------------------------------------
+	void ChannelArray::sleep(ID id) {
+		int index = _sparse[id & INDEX_MASK];
+		if (index != -1 && index < awake) {
+			--awake;
+			swap(index, awake);
+		}
+	}
+
+	// -----------------------------------------------
+	// add channel - appends a hot channel at runtime.
+	// The new channel is zeroed for all entities.
+	// -----------------------------------------------
+	int ChannelArray::addChannel(int channelSize) {
+		assert(_num_blocks + 1 < MAX_BLOCKS);
+		int channel = _num_blocks;
+		_sizes[channel] = channelSize;
+		++_num_blocks;
+		if (data != 0) {
+			reallocate(capacity, channel);
+		}
+		return channel;
+	}
+
 	// -----------------------------------------------
 	// resize
 	// -----------------------------------------------
 	bool ChannelArray::resize(int new_size) {
 		if (new_size > capacity) {
-			int total = 0;
-			for (int i = 0; i < _num_blocks; ++i) {
-				total += _sizes[i];
-			}
-			int sz = new_size * total;
-			char* t = (char*)ALLOC(sz);
-			if (data != 0) {
-				int offset = 0;
-				int old_offset = 0;
-				for (int i = 0; i < _num_blocks; ++i) {
-					memcpy(t + offset, data + old_offset, size * _sizes[i]);
-					offset += new_size * _sizes[i];
-					old_offset += capacity * _sizes[i];
-				}
-				DEALLOC(data);
+			reallocate((new_size + CHANNEL_PADDING - 1) & ~(CHANNEL_PADDING - 1), _num_blocks);
+			return true;
+		}
+		return false;
+	}
+
+	// -----------------------------------------------
+	// reallocate - the first num channels are copied. 
+	// The hot channels are copied by size and the cold
+	// channels by the old capacity since they are 
+	// indexed by ID. The grown part of the cold 
+	// channels and all other channels are zeroed.
+	// -----------------------------------------------
+	void ChannelArray::reallocate(int new_size, int num) {
+		int indices[MAX_BLOCKS];
+		int hotTotal = 0;
+		int coldTotal = 0;
+		for (int i = 0; i < _num_blocks; ++i) {
+			int sz = new_size * _sizes[i];
+			if (isCold(i)) {
+				indices[i] = coldTotal;
+				coldTotal += sz;
 			}
-			capacity = new_size;
-			_indices[0] = 0;
-			for (int i = 1; i < _num_blocks; ++i) {
-				_indices[i] = _indices[i - 1] + _sizes[i - 1] * capacity;
+			else {
+				indices[i] = hotTotal;
+				hotTotal += (sz + CHANNEL_ALIGNMENT - 1) & ~(CHANNEL_ALIGNMENT - 1);
 			}
-			data = t;
-			if (_sparse == 0) {
-				_sparse = (int*)ALLOC(new_size * sizeof(int));
-				for (int i = 0; i < new_size; ++i) {
-					_sparse[i] = -1;
+		}
+		char* hot = (char*)ALLOC(hotTotal + CHANNEL_ALIGNMENT);
+		char* t = (char*)memory::align_forward(hot, CHANNEL_ALIGNMENT);
+		char* c = 0;
+		if (coldTotal > 0) {
+			c = (char*)ALLOC(coldTotal);
+		}
+		for (int i = 0; i < _num_blocks; ++i) {
+			if (isCold(i)) {
+				if (i < num && data != 0) {
+					int copied = (capacity < new_size ? capacity : new_size) * _sizes[i];
+					memcpy(c + indices[i], cold + _indices[i], copied);
+					memset(c + indices[i] + copied, 0, new_size * _sizes[i] - copied);
+				}
+				else {
+					memset(c + indices[i], 0, new_size * _sizes[i]);
 				}
 			}
 			else {
-				int* tmp = (int*)ALLOC(new_size * sizeof(int));
-				memcpy(tmp, _sparse, size * sizeof(int));
-				for (int i = size; i < new_size; ++i) {
-					tmp[i] = -1;
+				if (i < num && data != 0) {
+					memcpy(t + indices[i], data + _indices[i], size * _sizes[i]);
+				}
+				else {
+					memset(t + indices[i], 0, new_size * _sizes[i]);
 				}
+			}
+		}
+		if (_hot != 0) {
+			DEALLOC(_hot);
+		}
+		if (cold != 0) {
+			DEALLOC(cold);
+		}
+		for (int i = 0; i < _num_blocks; ++i) {
+			_indices[i] = indices[i];
+		}
+		if (new_size > capacity) {
+			int* sparse = (int*)ALLOC(new_size * sizeof(int));
+			int* dense = (int*)ALLOC(new_size * sizeof(int));
+			if (_sparse != 0) {
+				memcpy(sparse, _sparse, capacity * sizeof(int));
+				memcpy(dense, _dense, capacity * sizeof(int));
 				DEALLOC(_sparse);
-				_sparse = tmp;
+				DEALLOC(_dense);
 			}
-			return true;
+			for (int i = capacity; i < new_size; ++i) {
+				sparse[i] = -1;
+				dense[i] = i;
+			}
+			_sparse = sparse;
+			_dense = dense;
+			capacity = new_size;
 		}
-		return false;
+		_hot = hot;
+		data = t;
+		cold = c;
 	}
 
 	// -----------------------------------------------
@@ -366,6 +529,17 @@ namespace ds {
 	// -----------------------------------------------
 	void* ChannelArray::get_ptr(int index) {
 		assert(index >= 0 && index < MAX_BLOCKS);
+		if (isCold(index)) {
+			return cold + _indices[index];
+		}
+		return data + _indices[index];
+	}
+
+	const void* ChannelArray::get_ptr(int index) const {
+		assert(index >= 0 && index < MAX_BLOCKS);
+		if (isCold(index)) {
+			return cold + _indices[index];
+		}
 		return data + _indices[index];
 	}
 
@@ -375,7 +549,7 @@ namespace ds {
 	void* ChannelArray::getPointer(int channel, ChannelType type) {
 		assert(channel >= 0 && channel < MAX_BLOCKS);
 		assert(_types[channel] == type);
-		return data + _indices[channel];
+		return get_ptr(channel);
 	}
 
 	// -----------------------------------------------
@@ -391,20 +565,28 @@ namespace ds {
 	}
 
 	// -----------------------------------------------
-	// remove
+	// remove - an awake entity is put to sleep first
+	// then the last entity is swapped into the free 
+	// slot. Only the hot channels are moved.
 	// -----------------------------------------------
 	void ChannelArray::remove(ID id) {
 		if (contains(id)) {
+			sleep(id);
 			int tmp = _sparse[id];
 			if (size > 0) {
-				int l = find(size - 1);
-				if (l != -1 && l != id) {
+				int l = _dense[size - 1];
+				if (l != id) {
 					for (int i = 0; i < _num_blocks; ++i) {
+						if (isCold(i)) {
+							continue;
+						}
 						int current = _indices[i] + _sparse[id] * _sizes[i];
 						int next = _indices[i] + (size - 1) * _sizes[i];
 						memcpy(data + current, data + next, _sizes[i]);
 					}
 					_sparse[l] = tmp;
+					_dense[tmp] = l;
+					_dense[size - 1] = id;
 				}
 			}
 			_sparse[id] = -1;
@@ -5,7 +5,7 @@
 #include "..\graphics\Texture.h"
 #include "..\math\tweening.h"
 
-const int MAX_BLOCKS = 16;
+const int MAX_BLOCKS = 24;
 
 struct BlockArray {
 
@@ -30,6 +30,8 @@ struct BlockArray {
 	void remove(int index);
 
 	void swap(int oldIndex, int newIndex);
+
+	void permute(const int* order);
 	
 };
 
@@ -88,48 +90,101 @@ namespace ds {
 		{ CT_TWN, sizeof(tweening::TweeningType) }
 	};
 
+	// alignment of the hot channels and the number of rows 
+	// the capacity is padded to so SIMD loops can run over
+	// the last partial block
+	const int CHANNEL_ALIGNMENT = 64;
+	const int CHANNEL_PADDING = 4;
+
+	class TextureTable;
+
+	// -----------------------------------------------
+	// ChannelArray
+	//
+	// Hot channels are stored by dense index in one
+	// cache line aligned allocation. Cold channels 
+	// (set by the cold mask in init) live in a second
+	// allocation indexed by the ID. They are never 
+	// moved on remove and only copied when the array
+	// grows. get_ptr on a cold channel returns the 
+	// ID indexed block. The cold values of a removed
+	// entity are cleared when the ID is reused by
+	// add. Hot channels can be
+	// added at runtime by addChannel. The dense rows
+	// are partitioned into awake rows [0, awake) and
+	// sleeping rows [awake, size).
+	// -----------------------------------------------
 	struct ChannelArray {
 
 		char* data;
+		char* cold;
 		int size;
+		int awake;
 		int capacity;
 		int total_capacity;
 		int _sizes[MAX_BLOCKS];
 		int _indices[MAX_BLOCKS];
 		ChannelType _types[MAX_BLOCKS];
 		int _num_blocks;
+		uint32_t _cold;
 		int* _sparse;
+		// IDs by dense index - the ones behind size are free
+		int* _dense;
+		char* _hot;
+		// texture table of compact storage - not owned
+		TextureTable* textures;
 
 		ChannelArray();
 
 		~ChannelArray();
 
-		void init(ChannelType* types, int num);
+		void init(ChannelType* types, int num, uint32_t coldChannels = 0);
 
-		void init(int* sizes, int num);
+		void init(int* sizes, int num, uint32_t coldChannels = 0);
 
 		ID add();
 
+		int addChannel(int channelSize);
+
+		ID getID(int index) const {
+			return _dense[index];
+		}
+
+		bool isAwake(ID id) const {
+			return _sparse[id & INDEX_MASK] < awake;
+		}
+
+		void wake(ID id);
+
+		void sleep(ID id);
+
+		bool isCold(int channel) const {
+			return (_cold & (1 << channel)) != 0;
+		}
+
+		// row of the entity in the given channel
+		int row(ID id, int channel) const {
+			assert(_sparse[id & INDEX_MASK] != -1);
+			if (isCold(channel)) {
+				return id & INDEX_MASK;
+			}
+			return _sparse[id & INDEX_MASK];
+		}
+
 		template<class T>
 		void set(ID id, int channel, const T& t) {
 			T* p = (T*)get_ptr(channel);
-			assert(_sparse[id] != -1);
-			unsigned short index = _sparse[id & INDEX_MASK];
-			p[index] = t;
+			p[row(id, channel)] = t;
 		}
 
 		void set(ID id, int channel, const Texture& t) {
 			Texture* p = (Texture*)get_ptr(channel);
-			assert(_sparse[id] != -1);
-			unsigned short index = _sparse[id & INDEX_MASK];
-			p[index] = t;
+			p[row(id, channel)] = t;
 		}
 
 		void set(ID id, int channel, const Rect& t) {
 			Rect* p = (Rect*)get_ptr(channel);
-			assert(_sparse[id] != -1);
-			unsigned short index = _sparse[id & INDEX_MASK];
-			p[index] = t;
+			p[row(id, channel)] = t;
 		}
 
 		const bool contains(ID id) const {
@@ -140,30 +195,32 @@ namespace ds {
 
 		template<class T>
 		const T& get(ID id, int channel) const {
-			const T* p = get_ptr(channel);
-			assert(_sparse[id] != -1);
-			unsigned short index = _sparse[id & INDEX_MASK];
-			return p[index];
+			const T* p = (const T*)get_ptr(channel);
+			return p[row(id, channel)];
 		}
 
 		template<class T>
 		T& get(ID id, int channel) {
 			T* p = (T*)get_ptr(channel);
-			assert(_sparse[id] != -1);
-			unsigned short index = _sparse[id & INDEX_MASK];
-			return p[index];
+			return p[row(id, channel)];
 		}
 
 		void* get_ptr(int channel);
 
+		const void* get_ptr(int channel) const;
+
 		void* getPointer(int channel,ChannelType type);
 
 		bool resize(int new_size);
 
+		void reallocate(int new_size, int num);
+
 		int find(int data_index) const;
 
 		int find_free() const;
 
+		void swap(int first, int second);
+
 	};
 
 }
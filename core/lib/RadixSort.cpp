@@ -0,0 +1,195 @@
+#include "RadixSort.h"
+#include "..\memory\DefaultAllocator.h"
+#include <string.h>
+
+namespace ds {
+
+	// the incremental sort accepts one break per this many keys
+	const uint32_t MAX_INCREMENTAL_BREAKS = 64;
+
+	static inline bool less(const uint64_t* keys, uint32_t a, uint32_t b) {
+		return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+	}
+
+	// -----------------------------------------------
+	// bottom up merge sort of indices - O(n log n) for
+	// the removed elements of the incremental sort. 
+	// Returns the buffer holding the result.
+	// -----------------------------------------------
+	static uint32_t* merge_sort(const uint64_t* keys, uint32_t* data, uint32_t* temp, uint32_t num) {
+		for (uint32_t width = 1; width < num; width *= 2) {
+			for (uint32_t start = 0; start < num; start += 2 * width) {
+				uint32_t mid = start + width < num ? start + width : num;
+				uint32_t end = start + 2 * width < num ? start + 2 * width : num;
+				uint32_t a = start;
+				uint32_t b = mid;
+				for (uint32_t i = start; i < end; ++i) {
+					if (a < mid && (b == end || !less(keys, data[b], data[a]))) {
+						temp[i] = data[a++];
+					}
+					else {
+						temp[i] = data[b++];
+					}
+				}
+			}
+			uint32_t* t = data;
+			data = temp;
+			temp = t;
+		}
+		return data;
+	}
+
+	RadixSort::RadixSort() : _data(0), _order(0), _temp(0), _keys(0), _tempKeys(0), _size(0), _capacity(0) {
+	}
+
+	RadixSort::~RadixSort() {
+		if (_data != 0) {
+			DEALLOC(_data);
+		}
+	}
+
+	// -----------------------------------------------
+	// reserve - keeps the current order
+	// -----------------------------------------------
+	void RadixSort::reserve(uint32_t num) {
+		if (num > _capacity) {
+			uint32_t capacity = num * 2;
+			char* data = (char*)ALLOC(capacity * (2 * sizeof(uint64_t) + 2 * sizeof(uint32_t)));
+			uint64_t* keys = (uint64_t*)data;
+			uint64_t* tempKeys = keys + capacity;
+			uint32_t* order = (uint32_t*)(tempKeys + capacity);
+			uint32_t* temp = order + capacity;
+			if (_data != 0) {
+				memcpy(order, _order, _size * sizeof(uint32_t));
+				DEALLOC(_data);
+			}
+			_data = data;
+			_keys = keys;
+			_tempKeys = tempKeys;
+			_order = order;
+			_temp = temp;
+			_capacity = capacity;
+		}
+	}
+
+	// -----------------------------------------------
+	// sort - all histograms are built in one pass
+	// -----------------------------------------------
+	const uint32_t* RadixSort::sort(const uint64_t* keys, uint32_t num) {
+		reserve(num);
+		_size = num;
+		uint32_t histograms[8][256];
+		memset(histograms, 0, sizeof(histograms));
+		for (uint32_t i = 0; i < num; ++i) {
+			uint64_t k = keys[i];
+			for (int d = 0; d < 8; ++d) {
+				++histograms[d][(k >> (d * 8)) & 0xff];
+			}
+			_keys[i] = k;
+			_order[i] = i;
+		}
+		for (int d = 0; d < 8; ++d) {
+			uint32_t* h = histograms[d];
+			if (num == 0 || h[(_keys[0] >> (d * 8)) & 0xff] == num) {
+				continue;
+			}
+			uint32_t total = 0;
+			for (int i = 0; i < 256; ++i) {
+				uint32_t c = h[i];
+				h[i] = total;
+				total += c;
+			}
+			int shift = d * 8;
+			for (uint32_t i = 0; i < num; ++i) {
+				uint32_t dest = h[(_keys[i] >> shift) & 0xff]++;
+				_tempKeys[dest] = _keys[i];
+				_temp[dest] = _order[i];
+			}
+			uint64_t* tk = _keys;
+			_keys = _tempKeys;
+			_tempKeys = tk;
+			uint32_t* t = _order;
+			_order = _temp;
+			_temp = t;
+		}
+		return _order;
+	}
+
+	// -----------------------------------------------
+	// sort incremental - both elements of every pair 
+	// in the last order that is no longer sorted are 
+	// taken out, sorted and merged back. The index is
+	// used as tie breaker so the result matches the 
+	// stable radix sort. Falls back to the radix sort
+	// if the number of keys changed or the order has
+	// too many breaks.
+	// -----------------------------------------------
+	const uint32_t* RadixSort::sortIncremental(const uint64_t* keys, uint32_t num) {
+		if (num != _size || num < 2) {
+			return sort(keys, num);
+		}
+		uint32_t breaks = 0;
+		for (uint32_t i = 1; i < num; ++i) {
+			if (!less(keys, _order[i - 1], _order[i])) {
+				++breaks;
+			}
+		}
+		if (breaks == 0) {
+			return _order;
+		}
+		if (breaks > num / MAX_INCREMENTAL_BREAKS) {
+			return sort(keys, num);
+		}
+		// the key buffer is not used here so it holds the removed elements
+		// and the scratch space of the merge sort
+		uint32_t* removed = (uint32_t*)_tempKeys;
+		uint32_t* scratch = removed + _capacity;
+		uint32_t numRemoved = 0;
+		uint32_t numKept = 0;
+		for (uint32_t i = 0; i < num; ++i) {
+			bool broken = (i > 0 && !less(keys, _order[i - 1], _order[i])) || (i + 1 < num && !less(keys, _order[i], _order[i + 1]));
+			if (broken) {
+				removed[numRemoved++] = _order[i];
+			}
+			else {
+				if (numKept > 0 && !less(keys, _temp[numKept - 1], _order[i])) {
+					return sort(keys, num);
+				}
+				_temp[numKept++] = _order[i];
+			}
+		}
+		removed = merge_sort(keys, removed, scratch, numRemoved);
+		uint32_t k = 0;
+		uint32_t r = 0;
+		for (uint32_t i = 0; i < num; ++i) {
+			if (r < numRemoved && (k == numKept || less(keys, removed[r], _temp[k]))) {
+				_order[i] = removed[r++];
+			}
+			else {
+				_order[i] = _temp[k++];
+			}
+		}
+		return _order;
+	}
+
+	namespace sort {
+
+		uint32_t float_key(float v) {
+			uint32_t bits;
+			memcpy(&bits, &v, sizeof(float));
+			return (bits & 0x80000000) != 0 ? ~bits : bits | 0x80000000;
+		}
+
+		// -----------------------------------------------
+		// sprite key - the low 8 bits of the depth key are
+		// dropped so sprites whose depth differs only in
+		// the last mantissa bits compare as equal and keep
+		// their index order
+		// -----------------------------------------------
+		uint64_t sprite_key(int layer, uint32_t texture, float depth) {
+			return ((uint64_t)(layer & 0xffff) << 48) | ((uint64_t)(texture & 0xffffff) << 24) | (float_key(depth) >> 8);
+		}
+
+	}
+
+}
\ No newline at end of file
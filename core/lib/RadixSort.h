@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+
+namespace ds {
+
+	// -----------------------------------------------
+	// RadixSort - stable LSD radix sort of 64 bit keys
+	// with 8 bit digits. It does not move the keys but
+	// returns a permutation: order[i] is the index of 
+	// the i-th smallest key. Passes where all keys 
+	// share the same digit are skipped.
+	// -----------------------------------------------
+	class RadixSort {
+
+	public:
+		RadixSort();
+		~RadixSort();
+		const uint32_t* sort(const uint64_t* keys, uint32_t num);
+		// starts from the order of the last call - when only a few
+		// keys are out of place they are removed, sorted and merged
+		// back. The result is identical to sort().
+		const uint32_t* sortIncremental(const uint64_t* keys, uint32_t num);
+		const uint32_t* getOrder() const {
+			return _order;
+		}
+		uint32_t size() const {
+			return _size;
+		}
+	private:
+		void reserve(uint32_t num);
+		char* _data;
+		uint32_t* _order;
+		uint32_t* _temp;
+		uint64_t* _keys;
+		uint64_t* _tempKeys;
+		uint32_t _size;
+		uint32_t _capacity;
+	};
+
+	namespace sort {
+
+		// maps a float to an unsigned int with the same order
+		uint32_t float_key(float v);
+
+		// layer : 16 bits, texture : 24 bits, depth : upper 24 bits of the float key
+		// (the low 8 bits of the depth are dropped)
+		uint64_t sprite_key(int layer, uint32_t texture, float depth);
+
+	}
+
+}
\ No newline at end of file
@@ -1,10 +1,15 @@
 #include "CubicBezierPath.h"
 #include "..\log\Log.h"
+#include "math.h"
 #include <assert.h>
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DS_PATH_SSE
+#include <xmmintrin.h>
+#endif
 
 namespace ds {
 
-	CubicBezierPath::CubicBezierPath() {}
+	CubicBezierPath::CubicBezierPath() : m_TotalLength(0.0f) , m_Refinement(0) {}
 
 	CubicBezierPath::~CubicBezierPath()	{}
 
@@ -53,14 +58,61 @@ namespace ds {
 		for ( int i = 0; i < m_Elements.size(); ++i ) {
 			m_Elements[i].build();
 		}
+		// power basis coefficients
+		m_Coefficients.clear();
+		m_ElementLength.clear();
+		for (int i = 0; i < m_Elements.size(); ++i) {
+			const BezierCurve& c = m_Elements[i];
+			m_Coefficients.push_back(-c.p0.x + 3.0f * c.p1.x - 3.0f * c.p2.x + c.p3.x);
+			m_Coefficients.push_back(3.0f * c.p0.x - 6.0f * c.p1.x + 3.0f * c.p2.x);
+			m_Coefficients.push_back(-3.0f * c.p0.x + 3.0f * c.p1.x);
+			m_Coefficients.push_back(c.p0.x);
+			m_Coefficients.push_back(-c.p0.y + 3.0f * c.p1.y - 3.0f * c.p2.y + c.p3.y);
+			m_Coefficients.push_back(3.0f * c.p0.y - 6.0f * c.p1.y + 3.0f * c.p2.y);
+			m_Coefficients.push_back(-3.0f * c.p0.y + 3.0f * c.p1.y);
+			m_Coefficients.push_back(c.p0.y);
+		}
+		for (int i = 0; i < m_Elements.size(); ++i) {
+			m_ElementLength.push_back(length(i, 1.0f));
+		}
+		// arc length table
+		for (int i = 0; i <= MAX_CBP_LUT; ++i) {
+			float u = static_cast<float>(i) / static_cast<float>(MAX_CBP_LUT);
+			m_ArcLUT[i] = find(u);
+		}
+		if (m_Refinement > 0) {
+			float total = 0.0f;
+			for (int i = 0; i < m_ElementLength.size(); ++i) {
+				total += m_ElementLength[i];
+			}
+			for (int i = 1; i < MAX_CBP_LUT; ++i) {
+				float target = static_cast<float>(i) / static_cast<float>(MAX_CBP_LUT) * total;
+				float t = m_ArcLUT[i];
+				for (int j = 0; j < m_Refinement; ++j) {
+					float sp = speed(t);
+					if (sp < 0.0001f) {
+						break;
+					}
+					t = math::clamp(t - (length(t) - target) / sp);
+				}
+				m_ArcLUT[i] = t;
+			}
+			m_TotalLength = total;
+		}
+		m_ArcLUT[0] = 0.0f;
+		m_ArcLUT[MAX_CBP_LUT] = 1.0f;
 	}
 
 	void CubicBezierPath::approx(float u, v2* p) const {
 		assert(u >= 0.0f && u <= 1.0f);
-		float t = find(u);
+		float t = lookup(m_ArcLUT, u);
 		get(t, p);
 	}
 
+	// -------------------------------------------------------
+	// find - inverts the sampled arc length table. Only used
+	// to build the lookup table
+	// -------------------------------------------------------
 	float CubicBezierPath::find(float u) const {
 		float targetLength = u * m_TotalLength;// [32];
 		int low = 0;
@@ -80,9 +132,15 @@ namespace ds {
 		if (m_ArcLength[index] > targetLength) {
 			index--;
 		}
+		if (index < 0) {
+			return 0.0f;
+		}
+		if (index >= MAX_CBP_STEPS) {
+			return 1.0f;
+		}
 		float lengthBefore = m_ArcLength[index];
 		if (lengthBefore == targetLength) {
-			return lengthBefore;
+			return index / static_cast<float>(MAX_CBP_STEPS);
 
 		}
 		else {
@@ -90,9 +148,69 @@ namespace ds {
 		}
 	}
 
+	// -------------------------------------------------------
+	// element - returns the element and the local parameter
+	// -------------------------------------------------------
+	int CubicBezierPath::element(float t, float* local) const {
+		int num = m_Elements.size();
+		float f = t * static_cast<float>(num);
+		int idx = static_cast<int>(f);
+		if (idx >= num) {
+			idx = num - 1;
+		}
+		if (idx < 0) {
+			idx = 0;
+		}
+		*local = f - static_cast<float>(idx);
+		return idx;
+	}
+
+	// -------------------------------------------------------
+	// speed - length of the first derivative
+	// -------------------------------------------------------
+	float CubicBezierPath::speed(float t) const {
+		float local = 0.0f;
+		int idx = element(t, &local);
+		const float* c = &m_Coefficients[idx * 8];
+		float dx = (3.0f * c[0] * local + 2.0f * c[1]) * local + c[2];
+		float dy = (3.0f * c[4] * local + 2.0f * c[5]) * local + c[6];
+		return sqrt(dx * dx + dy * dy) * static_cast<float>(m_Elements.size());
+	}
+
+	// -------------------------------------------------------
+	// length - arc length from 0 to t
+	// -------------------------------------------------------
+	float CubicBezierPath::length(float t) const {
+		float local = 0.0f;
+		int idx = element(t, &local);
+		float ret = 0.0f;
+		for (int i = 0; i < idx; ++i) {
+			ret += m_ElementLength[i];
+		}
+		return ret + length(idx, local);
+	}
+
+	// -------------------------------------------------------
+	// length of an element from 0 to t using Gauss-Legendre
+	// -------------------------------------------------------
+	float CubicBezierPath::length(int element, float t) const {
+		const float X[] = { -0.9061798459f, -0.5384693101f, 0.0f, 0.5384693101f, 0.9061798459f };
+		const float W[] = { 0.2369268851f, 0.4786286705f, 0.5688888889f, 0.4786286705f, 0.2369268851f };
+		const float* c = &m_Coefficients[element * 8];
+		float half = t * 0.5f;
+		float ret = 0.0f;
+		for (int i = 0; i < 5; ++i) {
+			float s = half * (X[i] + 1.0f);
+			float dx = (3.0f * c[0] * s + 2.0f * c[1]) * s + c[2];
+			float dy = (3.0f * c[4] * s + 2.0f * c[5]) * s + c[6];
+			ret += W[i] * sqrt(dx * dx + dy * dy);
+		}
+		return ret * half;
+	}
+
 	void CubicBezierPath::tanget(float u, v2* tangent) const {
 		assert(u >= 0.0f && u <= 1.0f);
-		float t = find(u);
+		float t = lookup(m_ArcLUT, u);
 		float ds = 1.0f / m_Elements.size();
 		int idx = t * m_Elements.size();
 		if (idx == m_Elements.size()) {
@@ -118,6 +236,60 @@ namespace ds {
 		}
 	}
 
+	// -------------------------------------------------------
+	// sample many - evaluates four points at once using the
+	// power basis if SSE is available
+	// -------------------------------------------------------
+	void CubicBezierPath::sampleMany(const float* u, v2* out, int num) const {
+		int i = 0;
+#ifdef DS_PATH_SSE
+		float lt[4];
+		const float* c[4];
+		float xs[4];
+		float ys[4];
+		for (; i + 4 <= num; i += 4) {
+			for (int j = 0; j < 4; ++j) {
+				int idx = element(lookup(m_ArcLUT, u[i + j]), &lt[j]);
+				c[j] = &m_Coefficients[idx * 8];
+			}
+			__m128 t = _mm_loadu_ps(lt);
+			__m128 x = _mm_setr_ps(c[0][0], c[1][0], c[2][0], c[3][0]);
+			x = _mm_add_ps(_mm_mul_ps(x, t), _mm_setr_ps(c[0][1], c[1][1], c[2][1], c[3][1]));
+			x = _mm_add_ps(_mm_mul_ps(x, t), _mm_setr_ps(c[0][2], c[1][2], c[2][2], c[3][2]));
+			x = _mm_add_ps(_mm_mul_ps(x, t), _mm_setr_ps(c[0][3], c[1][3], c[2][3], c[3][3]));
+			__m128 y = _mm_setr_ps(c[0][4], c[1][4], c[2][4], c[3][4]);
+			y = _mm_add_ps(_mm_mul_ps(y, t), _mm_setr_ps(c[0][5], c[1][5], c[2][5], c[3][5]));
+			y = _mm_add_ps(_mm_mul_ps(y, t), _mm_setr_ps(c[0][6], c[1][6], c[2][6], c[3][6]));
+			y = _mm_add_ps(_mm_mul_ps(y, t), _mm_setr_ps(c[0][7], c[1][7], c[2][7], c[3][7]));
+			_mm_storeu_ps(xs, x);
+			_mm_storeu_ps(ys, y);
+			for (int j = 0; j < 4; ++j) {
+				out[i + j].x = xs[j];
+				out[i + j].y = ys[j];
+			}
+		}
+#endif
+		for (; i < num; ++i) {
+			float t = 0.0f;
+			int idx = element(lookup(m_ArcLUT, u[i]), &t);
+			const float* c = &m_Coefficients[idx * 8];
+			out[i].x = ((c[0] * t + c[1]) * t + c[2]) * t + c[3];
+			out[i].y = ((c[4] * t + c[5]) * t + c[6]) * t + c[7];
+		}
+	}
+
+	void CubicBezierPath::tangentMany(const float* u, v2* out, int num) const {
+		for (int i = 0; i < num; ++i) {
+			float t = 0.0f;
+			int idx = element(lookup(m_ArcLUT, u[i]), &t);
+			const float* c = &m_Coefficients[idx * 8];
+			v2 d;
+			d.x = (3.0f * c[0] * t + 2.0f * c[1]) * t + c[2];
+			d.y = (3.0f * c[4] * t + 2.0f * c[5]) * t + c[6];
+			out[i] = normalize(d);
+		}
+	}
+
 	bool CubicBezierPath::loadData(const JSONReader& loader, int category) {
 		int num = 0;
 		loader.get_int(category, "num", &num);
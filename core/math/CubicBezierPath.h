@@ -8,6 +8,9 @@ namespace ds {
 
 	const int MAX_CBP_STEPS = 64;
 
+	// number of entries of the table mapping arc length to the curve parameter
+	const int MAX_CBP_LUT = 256;
+
 	class Path {
 
 	public:
@@ -19,6 +22,34 @@ namespace ds {
 		virtual void tanget(float u, v2* tangent) const = 0;
 		virtual const int size() const = 0;
 		virtual bool loadData(const JSONReader& loader, int category) = 0;
+		// -------------------------------------------------------
+		// batched versions of approx and tanget
+		// -------------------------------------------------------
+		virtual void sampleMany(const float* u, v2* out, int num) const {
+			for (int i = 0; i < num; ++i) {
+				approx(u[i], &out[i]);
+			}
+		}
+		virtual void tangentMany(const float* u, v2* out, int num) const {
+			for (int i = 0; i < num; ++i) {
+				tanget(u[i], &out[i]);
+			}
+		}
+	protected:
+		// -------------------------------------------------------
+		// maps normalized arc length to the curve parameter
+		// -------------------------------------------------------
+		static float lookup(const float* lut, float u) {
+			if (u <= 0.0f) {
+				return lut[0];
+			}
+			float f = u * static_cast<float>(MAX_CBP_LUT);
+			int idx = static_cast<int>(f);
+			if (idx >= MAX_CBP_LUT) {
+				return lut[MAX_CBP_LUT];
+			}
+			return lut[idx] + (lut[idx + 1] - lut[idx]) * (f - static_cast<float>(idx));
+		}
 	};
 	
 	class CubicBezierPath : public Path {
@@ -34,18 +65,36 @@ namespace ds {
 		void get(float t,v2* p) const;
 		void approx(float u, v2* p) const;
 		void tanget(float u, v2* tangent) const;
+		void sampleMany(const float* u, v2* out, int num) const;
+		void tangentMany(const float* u, v2* out, int num) const;
 		const int size() const {
 			return m_Elements.size();
 		}
 		const BezierCurve& getElement(int idx) const {
 			return m_Elements[idx];
 		}
+		float getLength() const {
+			return m_TotalLength;
+		}
+		// number of newton steps used to refine the arc length table in build (0 = off)
+		void setRefinement(int iterations) {
+			m_Refinement = iterations;
+		}
 		bool loadData(const JSONReader& loader, int category);
 	private:
 		float find(float u) const;
+		int element(float t, float* local) const;
+		float speed(float t) const;
+		float length(float t) const;
+		float length(int element, float t) const;
 		BezierElements m_Elements;
 		float m_TotalLength;
 		float m_ArcLength[MAX_CBP_STEPS+1];
+		float m_ArcLUT[MAX_CBP_LUT + 1];
+		// power basis coefficients ax,bx,cx,dx,ay,by,cy,dy per element
+		Array<float> m_Coefficients;
+		Array<float> m_ElementLength;
+		int m_Refinement;
 	};
 
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "math_types.h"
 #include "..\graphics\Color.h"
+#include "..\lib\collection_types.h"
 #include "tweening.h"
 
 namespace ds {
@@ -18,100 +19,145 @@ struct PathItem {
 	T value;
 };
 
-const int MAX_FLOAT_ARRAY_ITEMS = 20;
-
+const int DEFAULT_PATH_LUT_SIZE = 128;
+
+// -------------------------------------------------------
+// AbstractPath
+//
+// The keys are expected to be added in ascending order.
+// get uses a binary search to find the segment. After
+// calling bake the path can also be sampled in O(1) by
+// using the lookup table. Adding new keys will discard
+// the lookup table.
+// -------------------------------------------------------
 template<class T>
 class AbstractPath {
 
 public:
-	AbstractPath() : _count(0), _tweening(tweening::linear), _loopMode(PLM_LAST), _lastIndex(0), _lastTime(0.0f) {}
+	AbstractPath() : _loopMode(PLM_LAST), _tweening(tweening::linear), _lutStart(0.0f), _lutScale(0.0f) {}
+	AbstractPath(const AbstractPath& other) : _loopMode(PLM_LAST), _tweening(tweening::linear), _lutStart(0.0f), _lutScale(0.0f) {
+		copy(other);
+	}
 	~AbstractPath() {}
+
+	AbstractPath& operator=(const AbstractPath& other) {
+		if (this != &other) {
+			copy(other);
+		}
+		return *this;
+	}
 	
 	void add(float timeStep, const T& value) {
-		if (_count < 20) {
-			PathItem<T>* item = &_array[_count++];
-			item->time = timeStep;
-			item->value = value;
-		}
+		PathItem<T> item;
+		item.time = timeStep;
+		item.value = value;
+		_array.push_back(item);
+		_lut.clear();
 	}
 
 	float normalize(float time) const {
 		float normTime = time;
 		if (_loopMode == PLM_ZERO) {
-			float maxTime = _array[_count - 1].time;
+			float maxTime = _array[_array.size() - 1].time;
 			if (normTime > maxTime) {
 				normTime = 0.0f;
 			}
 		}
 		else if (_loopMode == PLM_LAST) {
-			float maxTime = _array[_count - 1].time;
+			float maxTime = _array[_array.size() - 1].time;
 			if (normTime > maxTime) {
 				normTime = maxTime;
 			}
 		}
 		else if (_loopMode == PLM_LOOP) {
 			float minTime = _array[0].time;
-			float maxTime = _array[_count - 1].time;
+			float maxTime = _array[_array.size() - 1].time;
 			normTime = fmod(time, (maxTime - minTime));
 		}
 		return normTime;
 	}
 
-	T get(float time) {
-		if (_count == 0) {
-			return 0.0f;
-		}
-		if (_count == 1) {
-			return _array[0].value;
-		}
-		float normTime = normalize(time);
-		// we assume that we are moving forward in time
-		int start = 0;
-		if (_lastIndex != -1 && _lastTime < time) {
-			start = _lastIndex;
-		}
-		else {
-			_lastIndex = -1;
-			_lastTime = 0.0f;
-		}
-		for (int i = start; i < _count - 1; ++i) {
-			PathItem<T>* current = &_array[i];
-			PathItem<T>* next = &_array[i + 1];
-			if (normTime >= current->time && normTime <= next->time) {
-				_lastIndex = i;
-				_lastTime = time;
-				float t = (normTime - current->time) / (next->time - current->time);
-				return tweening::interpolate(_tweening, current->value, next->value, t);
-			}
-		}
-		return 0.0f;
+	T get(float time) const {
+		T ret = T();
+		get(time, &ret);
+		return ret;
 	}
 
 	void get(float time,T* ret) const {
-		if (_count > 0) {
-			if (_count == 1) {
+		int count = _array.size();
+		if (count > 0) {
+			if (count == 1) {
 				*ret = _array[0].value;
 			}
 			else {
 				float normTime = normalize(time);
-				for (int i = 0; i < _count - 1; ++i) {
-					const PathItem<T>* current = &_array[i];
-					const PathItem<T>* next = &_array[i + 1];
-					if (normTime >= current->time && normTime <= next->time) {
-						float t = (normTime - current->time) / (next->time - current->time);
-						*ret = tweening::interpolate(_tweening, current->value, next->value, t, 1.0f);
-					}
+				int i = findSegment(normTime);
+				if (i != -1) {
+					const PathItem<T>& current = _array[i];
+					const PathItem<T>& next = _array[i + 1];
+					float t = (normTime - current.time) / (next.time - current.time);
+					*ret = tweening::interpolate(_tweening, current.value, next.value, t, 1.0f);
 				}
 			}
 		}
 	}
+
+	// -------------------------------------------------------
+	// bake - build a lookup table with resolution + 1 
+	// samples between the first and the last key
+	// -------------------------------------------------------
+	void bake(int resolution = DEFAULT_PATH_LUT_SIZE) {
+		_lut.clear();
+		int count = _array.size();
+		if (count > 1 && resolution > 0) {
+			_lutStart = _array[0].time;
+			float range = _array[count - 1].time - _lutStart;
+			_lutScale = range > 0.0f ? (float)resolution / range : 0.0f;
+			float step = range / (float)resolution;
+			for (int i = 0; i <= resolution; ++i) {
+				T v = _array[0].value;
+				get(_lutStart + step * (float)i, &v);
+				_lut.push_back(v);
+			}
+		}
+	}
+
+	bool isBaked() const {
+		return _lut.size() > 0;
+	}
+
+	// -------------------------------------------------------
+	// sample - uses the lookup table if the path is baked
+	// -------------------------------------------------------
+	T sample(float time) const {
+		if (_lut.size() == 0) {
+			return get(time);
+		}
+		float f = (normalize(time) - _lutStart) * _lutScale;
+		int last = _lut.size() - 1;
+		if (f <= 0.0f) {
+			return _lut[0];
+		}
+		if (f >= (float)last) {
+			return _lut[last];
+		}
+		int idx = (int)f;
+		return tweening::interpolate(tweening::linear, _lut[idx], _lut[idx + 1], f - (float)idx, 1.0f);
+	}
+
+	void sample(const float* times, T* ret, int num) const {
+		for (int i = 0; i < num; ++i) {
+			ret[i] = sample(times[i]);
+		}
+	}
 	
 	void reset() {
-		_count = 0;
+		_array.clear();
+		_lut.clear();
 	}
 
 	const int size() const {
-		return _count;
+		return _array.size();
 	}
 
 	const float key(int index) const {
@@ -124,18 +170,56 @@ public:
 
 	void setInterpolationMode(const tweening::TweeningType& tweening) {
 		_tweening = tweening;
+		_lut.clear();
 	}
 
 	void setLoopMode(const PathLoopMode& loopMode) {
 		_loopMode = loopMode;
 	}
 private:
-	PathItem<T> _array[MAX_FLOAT_ARRAY_ITEMS];
+	// -------------------------------------------------------
+	// find segment - binary search for the key before time
+	// -------------------------------------------------------
+	int findSegment(float time) const {
+		int count = _array.size();
+		if (time < _array[0].time || time > _array[count - 1].time) {
+			return -1;
+		}
+		int low = 0;
+		int high = count - 1;
+		while (high - low > 1) {
+			int mid = (low + high) / 2;
+			if (_array[mid].time <= time) {
+				low = mid;
+			}
+			else {
+				high = mid;
+			}
+		}
+		return low;
+	}
+
+	void copy(const AbstractPath& other) {
+		_array.clear();
+		for (uint32_t i = 0; i < other._array.size(); ++i) {
+			_array.push_back(other._array[i]);
+		}
+		_lut.clear();
+		for (uint32_t i = 0; i < other._lut.size(); ++i) {
+			_lut.push_back(other._lut[i]);
+		}
+		_loopMode = other._loopMode;
+		_tweening = other._tweening;
+		_lutStart = other._lutStart;
+		_lutScale = other._lutScale;
+	}
+
+	Array<PathItem<T>> _array;
+	Array<T> _lut;
 	PathLoopMode _loopMode;
-	int _count;
-	int _lastIndex;
-	float _lastTime;
 	tweening::TweeningType _tweening;
+	float _lutStart;
+	float _lutScale;
 };
 
 typedef AbstractPath<float> FloatArray;
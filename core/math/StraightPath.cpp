@@ -1,5 +1,6 @@
 #include "StraightPath.h"
 #include "..\log\Log.h"
+#include "math.h"
 #include <assert.h>
 
 namespace ds {
@@ -41,11 +42,35 @@ namespace ds {
 			}
 			previous = p;
 		}
+		// the arc length of a polyline is known exactly so the 
+		// lookup table is built from the segment lengths
+		float total = 0.0f;
+		for (int i = 0; i < m_Elements.size(); ++i) {
+			total += length(m_Elements[i].end - m_Elements[i].start);
+		}
+		int idx = 0;
+		float before = 0.0f;
+		for (int i = 0; i <= MAX_CBP_LUT; ++i) {
+			float target = static_cast<float>(i) / static_cast<float>(MAX_CBP_LUT) * total;
+			float current = length(m_Elements[idx].end - m_Elements[idx].start);
+			while (idx < m_Elements.size() - 1 && before + current < target) {
+				before += current;
+				++idx;
+				current = length(m_Elements[idx].end - m_Elements[idx].start);
+			}
+			float local = 0.0f;
+			if (current > 0.0f) {
+				local = math::clamp((target - before) / current);
+			}
+			m_ArcLUT[i] = (static_cast<float>(idx) + local) / static_cast<float>(m_Elements.size());
+		}
+		m_ArcLUT[0] = 0.0f;
+		m_ArcLUT[MAX_CBP_LUT] = 1.0f;
 	}
 
 	void StraightPath::approx(float u, v2* p) const {
 		assert(u >= 0.0f && u <= 1.0f);
-		float t = find(u);
+		float t = lookup(m_ArcLUT, u);
 		get(t, p);
 	}
 
@@ -82,7 +107,7 @@ namespace ds {
 
 	void StraightPath::tanget(float u, v2* tangent) const {
 		assert(u >= 0.0f && u <= 1.0f);
-		float t = find(u);
+		float t = lookup(m_ArcLUT, u);
 		float ds = 1.0f / m_Elements.size();
 		int idx = t * m_Elements.size();
 		if (idx == m_Elements.size()) {
@@ -108,6 +133,37 @@ namespace ds {
 		}
 	}
 
+	// -------------------------------------------------------
+	// sample many
+	// -------------------------------------------------------
+	void StraightPath::sampleMany(const float* u, v2* out, int num) const {
+		int n = m_Elements.size();
+		for (int i = 0; i < num; ++i) {
+			float t = lookup(m_ArcLUT, u[i]) * static_cast<float>(n);
+			int idx = static_cast<int>(t);
+			if (idx >= n) {
+				idx = n - 1;
+			}
+			const LineSegment& ls = m_Elements[idx];
+			out[i] = lerp(ls.start, ls.end, t - static_cast<float>(idx));
+		}
+	}
+
+	// -------------------------------------------------------
+	// tangent many - the direction of the segment
+	// -------------------------------------------------------
+	void StraightPath::tangentMany(const float* u, v2* out, int num) const {
+		int n = m_Elements.size();
+		for (int i = 0; i < num; ++i) {
+			int idx = static_cast<int>(lookup(m_ArcLUT, u[i]) * static_cast<float>(n));
+			if (idx >= n) {
+				idx = n - 1;
+			}
+			const LineSegment& ls = m_Elements[idx];
+			out[i] = normalize(ls.end - ls.start);
+		}
+	}
+
 	bool StraightPath::loadData(const JSONReader& loader, int category) {
 		int num = 0;
 		loader.get_int(category, "num", &num);
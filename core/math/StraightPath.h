@@ -24,6 +24,8 @@ namespace ds {
 		void get(float t, v2* p) const;
 		void approx(float u, Vector2f* p) const;
 		void tanget(float u, Vector2f* tangent) const;
+		void sampleMany(const float* u, v2* out, int num) const;
+		void tangentMany(const float* u, v2* out, int num) const;
 		const int size() const {
 			return m_Elements.size();
 		}
@@ -33,6 +35,7 @@ namespace ds {
 		LineElements m_Elements;
 		float m_TotalLength;
 		float m_ArcLength[MAX_CBP_STEPS + 1];
+		float m_ArcLUT[MAX_CBP_LUT + 1];
 	};
 
 	class GridPath : public StraightPath {
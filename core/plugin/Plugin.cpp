@@ -1,6 +1,7 @@
 #include "Plugin.h"
 #include "..\lib\collection_types.h"
 #include "..\profiler\Profiler.h"
+#include "..\jobs\FrameGraph.h"
 
 namespace ds {
 
@@ -33,6 +34,31 @@ namespace ds {
 			}
 		}
 
+		static void tickPlugin(void* data, float dt) {
+			Plugin* plugin = (Plugin*)data;
+			if (plugin->isActive()) {
+				plugin->tick(dt);
+			}
+		}
+
+		// -----------------------------------------------
+		// add one task per plugin - returns the task 
+		// joining all of them
+		// -----------------------------------------------
+		int addTasks(FrameGraph* graph) {
+			int first = graph->size();
+			uint32_t sz = _pluginCtx->plugins.size();
+			for (uint32_t i = 0; i < sz; ++i) {
+				Plugin* plugin = _pluginCtx->plugins[i];
+				graph->add(plugin->getName(), tickPlugin, plugin, plugin->isConcurrent() ? FTF_NONE : FTF_MAIN_THREAD);
+			}
+			int join = graph->add("UPDATE::Plugins", 0, 0);
+			for (int i = first; i < join; ++i) {
+				graph->dependsOn(join, i);
+			}
+			return join;
+		}
+
 		void preRender() {
 			ZoneTracker("Render::Plugins-Pre");
 			uint32_t sz = _pluginCtx->plugins.size();
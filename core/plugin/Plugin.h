@@ -5,6 +5,8 @@
 
 namespace ds {
 
+	class FrameGraph;
+
 	class Plugin {
 
 	public:
@@ -13,6 +15,11 @@ namespace ds {
 		}
 		virtual ~Plugin() {}
 		virtual void tick(float dt) {}
+		// a concurrent plugin ticks on the job system - it must not
+		// touch the World, the profiler or any other plugin
+		virtual bool isConcurrent() const {
+			return false;
+		}
 		virtual void preRender() {}
 		virtual void postRender() {}
 		virtual void activate() {
@@ -49,6 +56,8 @@ namespace ds {
 
 		void tick(float dt);
 
+		int addTasks(FrameGraph* graph);
+
 		void preRender();
 
 		void postRender();
@@ -2,6 +2,7 @@
 #include "..\log\Log.h"
 #include "..\imgui\IMGUI.h"
 #include "..\base\Assert.h"
+#include "..\jobs\FrameGraph.h"
 
 namespace ds {
 
@@ -103,6 +104,18 @@ namespace ds {
 		return false;
 	}
 
+	static void tickStates(void* data, float dt) {
+		StateManager* manager = (StateManager*)data;
+		manager->tick(dt);
+	}
+
+	// -------------------------------------------------------
+	// add task
+	// -------------------------------------------------------
+	int StateManager::addTask(FrameGraph* graph) {
+		return graph->add("UPDATE::States", tickStates, this, FTF_MAIN_THREAD);
+	}
+
 	// -------------------------------------------------------
 	// tick
 	// -------------------------------------------------------
@@ -77,6 +77,8 @@ namespace ds {
 		int outcome;
 		float ttl;
 	};
+	class FrameGraph;
+
 	// -------------------------------------------------------
 	// State manager
 	// -------------------------------------------------------
@@ -96,6 +98,7 @@ namespace ds {
 		void addTransition(int from, int outcome, int to, float ttl = 0.0f);
 		void activate(int mode);
 		void tick(float dt);
+		int addTask(FrameGraph* graph);
 		void stop();
 		int getCurrentMode() const {
 			return _current;
@@ -75,6 +75,25 @@ namespace ds {
 			events.push_back(e);
 		}
 
+		// appends all events of the other buffer and rebases their data
+		void append(const ActionEventBuffer& other) {
+			if (other.data.size > 0) {
+				data.resize(data.size + other.data.size + 8);
+			}
+			int offset = data.size;
+			if (other.data.size > 0) {
+				void* dest = data.alloc(other.data.size);
+				memcpy(dest, other.data.data, other.data.size);
+			}
+			for (uint32_t i = 0; i < other.events.size(); ++i) {
+				ActionEvent e = other.events[i];
+				if (e.dataIndex != -1) {
+					e.dataIndex += offset;
+				}
+				events.push_back(e);
+			}
+		}
+
 		void* get(int dataIndex) const {
 			return (void*)(data.data + dataIndex);
 		}
@@ -0,0 +1,61 @@
+#include "ActionLOD.h"
+#include "..\base\Assert.h"
+
+namespace ds {
+
+	ActionLOD::ActionLOD() : _numBands(0), _minX(0.0f), _maxX(0.0f), _minY(0.0f), _maxY(0.0f), _frame(0) {
+		for (int i = 0; i < MAX_LOD_INTERVAL; ++i) {
+			_dts[i] = 0.0f;
+		}
+	}
+
+	void ActionLOD::setView(const Rect& view) {
+		_minX = view.left < view.right ? view.left : view.right;
+		_maxX = view.left < view.right ? view.right : view.left;
+		_minY = view.bottom < view.top ? view.bottom : view.top;
+		_maxY = view.bottom < view.top ? view.top : view.bottom;
+	}
+
+	void ActionLOD::setBands(const LODBand* bands, int num) {
+		XASSERT(num <= MAX_LOD_BANDS, "Too many LOD bands: %d (max %d)", num, MAX_LOD_BANDS);
+		for (int i = 0; i < num; ++i) {
+			XASSERT(bands[i].interval >= 1 && bands[i].interval <= MAX_LOD_INTERVAL, "Invalid LOD interval: %d", bands[i].interval);
+			_bands[i] = bands[i];
+		}
+		_numBands = num;
+	}
+
+	// -----------------------------------------------
+	// get band - by the distance outside of the view.
+	// Everything behind the last band uses the last.
+	// -----------------------------------------------
+	int ActionLOD::getBand(const v3& p) const {
+		float dx = p.x < _minX ? _minX - p.x : (p.x > _maxX ? p.x - _maxX : 0.0f);
+		float dy = p.y < _minY ? _minY - p.y : (p.y > _maxY ? p.y - _maxY : 0.0f);
+		float d = dx > dy ? dx : dy;
+		for (int i = 0; i < _numBands - 1; ++i) {
+			if (d <= _bands[i].distance) {
+				return i;
+			}
+		}
+		return _numBands - 1;
+	}
+
+	void ActionLOD::advance(float dt) {
+		_dts[_frame % MAX_LOD_INTERVAL] = dt;
+		++_frame;
+	}
+
+	// -----------------------------------------------
+	// get elapsed - sum of the last frames including
+	// the current one
+	// -----------------------------------------------
+	float ActionLOD::getElapsed(int frames) const {
+		float elapsed = 0.0f;
+		for (int i = 1; i <= frames; ++i) {
+			elapsed += _dts[(_frame - i) % MAX_LOD_INTERVAL];
+		}
+		return elapsed;
+	}
+
+}
\ No newline at end of file
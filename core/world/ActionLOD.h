@@ -0,0 +1,60 @@
+#pragma once
+#include "..\Common.h"
+#include "..\math\math_types.h"
+
+namespace ds {
+
+	const int MAX_LOD_BANDS = 8;
+	// the longest interval in frames - the elapsed time of this many frames is kept
+	const int MAX_LOD_INTERVAL = 32;
+
+	// -----------------------------------------------
+	// LODBand - entities up to distance outside of the
+	// view are updated every interval frames
+	// -----------------------------------------------
+	struct LODBand {
+		float distance;
+		int interval;
+	};
+
+	// -----------------------------------------------
+	// ActionLOD - maps the position of an entity to a
+	// band and keeps the frame time of the last frames
+	// so an action updated every n frames receives the
+	// time elapsed since its last update. 
+	// -----------------------------------------------
+	class ActionLOD {
+
+	public:
+		ActionLOD();
+		~ActionLOD() {}
+		void setView(const Rect& view);
+		// the bands must be sorted by distance - no bands disables the LOD
+		void setBands(const LODBand* bands, int num);
+		bool isEnabled() const {
+			return _numBands > 0;
+		}
+		int getNumBands() const {
+			return _numBands;
+		}
+		int getInterval(int band) const {
+			return _bands[band].interval;
+		}
+		int getBand(const v3& p) const;
+		void advance(float dt);
+		uint32_t getFrame() const {
+			return _frame;
+		}
+		float getElapsed(int frames) const;
+	private:
+		LODBand _bands[MAX_LOD_BANDS];
+		int _numBands;
+		float _minX;
+		float _maxX;
+		float _minY;
+		float _maxY;
+		float _dts[MAX_LOD_INTERVAL];
+		uint32_t _frame;
+	};
+
+}
\ No newline at end of file
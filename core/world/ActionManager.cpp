@@ -17,11 +17,14 @@
 #include "actions\ColorFlashAction.h"
 #include "actions\WiggleAction.h"
 #include "actions\AlignToForceAction.h"
+#include "actions\FollowPathAction.h"
 #include "actions\CollisionAction.h"
+#include "ActionScheduler.h"
+#include "DirtyChannels.h"
 
 namespace ds {
 
-	ActionManager::ActionManager(ChannelArray* data, Rect boundingRect) : _data(data) , _boundingRect(boundingRect) {
+	ActionManager::ActionManager(ChannelArray* data, Rect boundingRect, TimerWheel* timers) : _data(data) , _timers(timers) , _boundingRect(boundingRect) , _tweenMode(TM_EAGER) , _fused(false) , _scheduler(0) , _dirty(0) {
 		_collisionAction = 0;
 		for (int i = 0; i < MAX_ACTIONS; ++i) {
 			_actions[i] = 0;
@@ -38,6 +41,22 @@ namespace ds {
 		if (_collisionAction != 0) {
 			delete _collisionAction;
 		}
+		if (_scheduler != 0) {
+			delete _scheduler;
+		}
+	}
+
+	// -----------------------------------------------
+	// set dirty channels - the actions mark the rows
+	// they have written
+	// -----------------------------------------------
+	void ActionManager::setDirtyChannels(DirtyChannels* dirty) {
+		_dirty = dirty;
+		for (int i = 0; i < MAX_ACTIONS; ++i) {
+			if (_actions[i] != 0) {
+				_actions[i]->setDirtyChannels(dirty);
+			}
+		}
 	}
 
 	void ActionManager::setBoundingRect(const Rect& boundingRect) {
@@ -82,11 +101,94 @@ namespace ds {
 		return false;
 	}
 
+	void ActionManager::markActive(uint32_t* bits) const {
+		for (int i = 0; i < MAX_ACTIONS; ++i) {
+			if (_actions[i] != 0) {
+				_actions[i]->markActive(bits);
+			}
+		}
+	}
+
 	void ActionManager::update(float dt, ActionEventBuffer& buffer) {
 		ZoneTracker u1("World::tick::update");
+		_lod.advance(dt);
+		if (_fused) {
+			for (int i = 0; i < MAX_ACTIONS; ++i) {
+				if (_actions[i] != 0) {
+					_actions[i]->sortRows();
+				}
+			}
+		}
+		// LOD and budgets are only handled by the serial update
+		bool sliced = _lod.isEnabled();
+		for (int i = 0; i < MAX_ACTIONS; ++i) {
+			if (_actions[i] != 0 && _actions[i]->getBudget() > 0) {
+				sliced = true;
+			}
+		}
+		if (_scheduler != 0 && !sliced) {
+			// the workers must not touch the dirty bits so the rows are marked up front
+			for (int i = 0; i < MAX_ACTIONS; ++i) {
+				if (_actions[i] != 0 && _actions[i]->writesOnUpdate()) {
+					_actions[i]->markRows(0, _actions[i]->getNumRows());
+				}
+			}
+			_scheduler->update(_actions, MAX_ACTIONS, dt, buffer);
+		}
+		else {
+			for (int i = 0; i < MAX_ACTIONS; ++i) {
+				if (_actions[i] != 0) {
+					_actions[i]->updateLOD(dt, buffer, _lod);
+				}
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// set job system
+	// -----------------------------------------------
+	void ActionManager::setJobSystem(JobSystem* jobs) {
+		if (_scheduler != 0) {
+			delete _scheduler;
+			_scheduler = 0;
+		}
+		if (jobs != 0) {
+			_scheduler = new ActionScheduler(jobs);
+		}
+	}
+
+	// -----------------------------------------------
+	// dispatch expired timer to the owning action
+	// -----------------------------------------------
+	void ActionManager::onTimer(const TimerEvent& e, ActionEventBuffer& buffer) {
+		if (_actions[e.type] != 0) {
+			_actions[e.type]->onTimer(e, buffer);
+		}
+	}
+
+	// -----------------------------------------------
+	// set tween mode
+	// -----------------------------------------------
+	void ActionManager::setTweenMode(TweenMode mode) {
+		_tweenMode = mode;
 		for (int i = 0; i < MAX_ACTIONS; ++i) {
 			if (_actions[i] != 0) {
-				_actions[i]->update(dt, buffer);
+				_actions[i]->setTweenMode(mode);
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// write all lazily evaluated tweens into the channels.
+	// Only the tweens that did not write on update are
+	// marked dirty.
+	// -----------------------------------------------
+	void ActionManager::materialize() {
+		ZoneTracker u1("World::materialize");
+		for (int i = 0; i < MAX_ACTIONS; ++i) {
+			if (_actions[i] != 0 && !_actions[i]->writesOnUpdate()) {
+				_actions[i]->materialize();
+				_actions[i]->markRows(0, _actions[i]->getNumRows());
 			}
 		}
 	}
@@ -118,6 +220,14 @@ namespace ds {
 			case AT_ROTATE_BY: _actions[AT_ROTATE_BY] = new RotateByAction(_data, _boundingRect); break;
 			case AT_WIGGLE: _actions[AT_WIGGLE] = new WiggleAction(_data, _boundingRect); break;
 			case AT_ALIGN_TO_FORCE: _actions[AT_ALIGN_TO_FORCE] = new AlignToForceAction(_data, _boundingRect); break;
+			case AT_FOLLOW_PATH: _actions[AT_FOLLOW_PATH] = new FollowPathAction(_data, _boundingRect, AT_FOLLOW_PATH, "follow_path"); break;
+			case AT_FOLLOW_CURVE: _actions[AT_FOLLOW_CURVE] = new FollowPathAction(_data, _boundingRect, AT_FOLLOW_CURVE, "follow_curve"); break;
+			case AT_FOLLOW_STRAIGHT_PATH: _actions[AT_FOLLOW_STRAIGHT_PATH] = new FollowPathAction(_data, _boundingRect, AT_FOLLOW_STRAIGHT_PATH, "follow_straight_path"); break;
+			}
+			if (_actions[type] != 0) {
+				_actions[type]->setTweenMode(_tweenMode);
+				_actions[type]->setTimerWheel(_timers, TO_ACTION, type);
+				_actions[type]->setDirtyChannels(_dirty);
 			}
 		}
 	}
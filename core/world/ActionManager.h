@@ -2,18 +2,33 @@
 #include "..\lib\BlockArray.h"
 #include "..\math\math_types.h"
 #include "ActionEventBuffer.h"
+#include "TimerWheel.h"
+#include "ActionLOD.h"
 
 namespace ds {
 
 	class CollisionAction;
 	class AbstractAction;
+	class ActionScheduler;
+	class JobSystem;
+	class DirtyChannels;
 
 	const int MAX_ACTIONS = 32;
 
+	// -----------------------------------------------
+	// TM_EAGER writes tweened values every tick, TM_LAZY
+	// only handles completion and leaves writing the
+	// channels to materialize()
+	// -----------------------------------------------
+	enum TweenMode {
+		TM_EAGER,
+		TM_LAZY
+	};
+
 	class ActionManager {
 
 	public:
-		ActionManager(ChannelArray* data, Rect boundingRect);
+		ActionManager(ChannelArray* data, Rect boundingRect, TimerWheel* timers);
 		~ActionManager();
 		void setBoundingRect(const Rect& boundingRect);
 		AbstractAction* get(ActionType type);
@@ -21,15 +36,48 @@ namespace ds {
 		void stopAction(ID id, ActionType type);
 		bool isActive(ID id, ActionType type);
 		void update(float dt, ActionEventBuffer& buffer);
+		void onTimer(const TimerEvent& e, ActionEventBuffer& buffer);
+		void setTweenMode(TweenMode mode);
+		TweenMode getTweenMode() const {
+			return _tweenMode;
+		}
+		void materialize();
+		// sets the bit of every entity attached to an action except collisions
+		void markActive(uint32_t* bits) const;
+		// in fused mode every action sorts its rows by dense
+		// entity index before the update
+		void setFused(bool fused) {
+			_fused = fused;
+		}
+		bool isFused() const {
+			return _fused;
+		}
+		// runs actions touching disjoint channels on the job system - 0 = serial
+		void setJobSystem(JobSystem* jobs);
+		bool isParallel() const {
+			return _scheduler != 0;
+		}
+		// the actions mark the rows they write in the tracked channels
+		void setDirtyChannels(DirtyChannels* dirty);
+		// view and bands used to update off screen entities at a lower rate
+		ActionLOD& getLOD() {
+			return _lod;
+		}
 		void saveReport(const ReportWriter& writer);
 		CollisionAction* getCollisionAction();
 		bool supportCollisions() const;
 	private:
 		void createAction(ActionType type);
 		ChannelArray* _data;
+		TimerWheel* _timers;
 		Rect _boundingRect;
 		AbstractAction* _actions[MAX_ACTIONS];
 		CollisionAction* _collisionAction;
+		TweenMode _tweenMode;
+		bool _fused;
+		ActionScheduler* _scheduler;
+		DirtyChannels* _dirty;
+		ActionLOD _lod;
 	};
 
 }
\ No newline at end of file
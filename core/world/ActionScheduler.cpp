@@ -0,0 +1,140 @@
+#include "ActionScheduler.h"
+#include "ActionManager.h"
+#include "actions\AbstractAction.h"
+#include "..\jobs\JobSystem.h"
+#include "..\base\Assert.h"
+
+namespace ds {
+
+	ActionScheduler::ActionScheduler(JobSystem* jobs) : _jobs(jobs), _numTasks(0), _dt(0.0f) {
+	}
+
+	// -----------------------------------------------
+	// update - build the waves and run them one after
+	// the other
+	// -----------------------------------------------
+	void ActionScheduler::update(AbstractAction** actions, int num, float dt, ActionEventBuffer& buffer) {
+		assert(num <= MAX_ACTIONS);
+		_dt = dt;
+		_numTasks = 0;
+		int waves[MAX_ACTIONS];
+		int numWaves = 0;
+		for (int i = 0; i < num; ++i) {
+			waves[i] = -1;
+			AbstractAction* a = actions[i];
+			if (a == 0) {
+				continue;
+			}
+			uint32_t reads = a->getReadChannels();
+			uint32_t writes = a->getWriteChannels();
+			int wave = 0;
+			for (int j = 0; j < i; ++j) {
+				if (waves[j] != -1) {
+					AbstractAction* o = actions[j];
+					if ((writes & (o->getReadChannels() | o->getWriteChannels())) != 0 || (reads & o->getWriteChannels()) != 0) {
+						if (waves[j] + 1 > wave) {
+							wave = waves[j] + 1;
+						}
+					}
+				}
+			}
+			waves[i] = wave;
+			if (wave + 1 > numWaves) {
+				numWaves = wave + 1;
+			}
+			uint32_t rows = a->getNumRows();
+			uint32_t chunks = 1;
+			if (a->supportsChunks() && _jobs->getNumWorkers() > 0) {
+				chunks = rows / MIN_ACTION_CHUNK;
+				uint32_t threads = _jobs->getNumWorkers() + 1;
+				if (chunks > threads) {
+					chunks = threads;
+				}
+				// keep one task for every remaining action
+				uint32_t left = MAX_ACTION_TASKS - _numTasks - (num - i - 1);
+				if (chunks > left) {
+					chunks = left;
+				}
+			}
+			if (chunks > 1) {
+				uint32_t step = (rows + chunks - 1) / chunks;
+				for (uint32_t s = 0; s < rows; s += step) {
+					uint32_t e = s + step;
+					if (e > rows) {
+						e = rows;
+					}
+					addTask(a, wave, s, e, true);
+				}
+			}
+			else {
+				addTask(a, wave, 0, rows, false);
+			}
+		}
+		for (int w = 0; w < numWaves; ++w) {
+			int count = 0;
+			for (int i = 0; i < _numTasks; ++i) {
+				if (_tasks[i].wave == w) {
+					_order[count++] = i;
+				}
+			}
+			if (count == 1) {
+				execute(_order[0]);
+			}
+			else if (count > 1) {
+				JobCounter counter;
+				_jobs->parallel_for(0, count, 1, runTasks, this, &counter);
+				_jobs->wait(&counter);
+			}
+		}
+		for (int i = 0; i < _numTasks; ++i) {
+			buffer.append(_buffers[i]);
+		}
+	}
+
+	// -----------------------------------------------
+	// add task - the memory allocator is not thread safe
+	// so the event buffer is grown up front
+	// -----------------------------------------------
+	void ActionScheduler::addTask(AbstractAction* action, int wave, uint32_t start, uint32_t end, bool chunked) {
+		assert(_numTasks < MAX_ACTION_TASKS);
+		ActionTask& t = _tasks[_numTasks];
+		t.action = action;
+		t.start = start;
+		t.end = end;
+		t.wave = wave;
+		t.chunked = chunked;
+		ActionEventBuffer& b = _buffers[_numTasks];
+		b.reset();
+		uint32_t events = (end - start + 1) * action->getMaxEventsPerRow();
+		b.events.reserve(events);
+		b.data.resize(events * MAX_ACTION_EVENT_DATA);
+		++_numTasks;
+	}
+
+	void ActionScheduler::runTasks(void* data, int start, int end) {
+		ActionScheduler* scheduler = (ActionScheduler*)data;
+		for (int i = start; i < end; ++i) {
+			scheduler->execute(scheduler->_order[i]);
+		}
+	}
+
+	// -----------------------------------------------
+	// execute - a buffer growing beyond the reserved
+	// size means the action adds more events per row
+	// than it declares
+	// -----------------------------------------------
+	void ActionScheduler::execute(int index) {
+		const ActionTask& t = _tasks[index];
+		ActionEventBuffer& b = _buffers[index];
+		uint32_t events = b.events.capacity();
+		int data = b.data.capacity;
+		if (t.chunked) {
+			t.action->updateChunk(_dt, b, t.start, t.end);
+		}
+		else {
+			t.action->update(_dt, b);
+		}
+		XASSERT(b.events.capacity() == events && b.data.capacity == data, "%s adds more than %d events per row", t.action->getName(), t.action->getMaxEventsPerRow());
+	}
+
+}
\ No newline at end of file
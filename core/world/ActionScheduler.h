@@ -0,0 +1,52 @@
+#pragma once
+#include "ActionEventBuffer.h"
+
+namespace ds {
+
+	class AbstractAction;
+	class JobSystem;
+
+	const int MAX_ACTION_TASKS = 96;
+	// minimum number of rows per chunk
+	const uint32_t MIN_ACTION_CHUNK = 1024;
+	// an event added by an update carries up to this many bytes of data
+	const int MAX_ACTION_EVENT_DATA = 16;
+
+	struct ActionTask {
+		AbstractAction* action;
+		uint32_t start;
+		uint32_t end;
+		int wave;
+		bool chunked;
+	};
+
+	// -----------------------------------------------
+	// ActionScheduler - runs the actions in waves on 
+	// the job system. An action is placed in a later 
+	// wave than every previous action writing a channel
+	// it reads or writes and vice versa. Every task 
+	// collects its events in a separate buffer and all
+	// buffers are merged in action order, so the 
+	// result is identical to the serial update. The
+	// buffers are reserved for getMaxEventsPerRow 
+	// events per row since workers must not allocate.
+	// -----------------------------------------------
+	class ActionScheduler {
+
+	public:
+		ActionScheduler(JobSystem* jobs);
+		~ActionScheduler() {}
+		void update(AbstractAction** actions, int num, float dt, ActionEventBuffer& buffer);
+	private:
+		static void runTasks(void* data, int start, int end);
+		void addTask(AbstractAction* action, int wave, uint32_t start, uint32_t end, bool chunked);
+		void execute(int index);
+		JobSystem* _jobs;
+		ActionTask _tasks[MAX_ACTION_TASKS];
+		ActionEventBuffer _buffers[MAX_ACTION_TASKS];
+		int _order[MAX_ACTION_TASKS];
+		int _numTasks;
+		float _dt;
+	};
+
+}
\ No newline at end of file
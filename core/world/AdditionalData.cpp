@@ -5,44 +5,61 @@
 
 namespace ds {
 
+	AdditionalData::~AdditionalData() {
+		for (uint32_t i = 0; i < _pools.size(); ++i) {
+			AdditionalDataPool* pool = _pools[i];
+			for (uint32_t j = 0; j < pool->pages.size(); ++j) {
+				DEALLOC(pool->pages[j]);
+			}
+			delete pool;
+		}
+	}
+
 	// -----------------------------------------------------
-	// attach
+	// attach - replaces any data already attached
 	// -----------------------------------------------------
 	void* AdditionalData::attach(ID sid, int size,int identifier) {
 		ZoneTracker z("AdditionalData::attach");
-		int idx = find_free_header(size);
-		if (idx == -1) {
-			AdditionalDataHeader header;
-			header.sid = sid;
-			header.size = size;
-			header.index = data.size;
-			header.used = true;
-			header.identifier = identifier;
-			//LOGC("World") << "==> attached sid: " << sid << " size: " << size << " identifier: " << identifier << " index: " << header.index;
-			headers.push_back(header);
-			return data.alloc(size);
+		uint32_t idx = sid & INDEX_MASK;
+		while (_slots.size() <= idx) {
+			Slot slot;
+			slot.pool = -1;
+			slot.block = -1;
+			_slots.push_back(slot);
 		}
-		else {
-			AdditionalDataHeader& header = headers[idx];
-			header.used = true;
-			header.sid = sid;
-			header.identifier = identifier;
-			//LOGC("World") << "==> reusing sid: " << sid << " size: " << size << " identifier: " << identifier << " index: " << header.index;
-			return data.data + header.index;
+		if (_slots[idx].pool != -1) {
+			remove(sid);
 		}
+		int p = find_pool(size, identifier);
+		AdditionalDataPool* pool = _pools[p];
+		if (pool->free.size() == 0) {
+			pool->pages.push_back((char*)ALLOC(ADDITIONAL_DATA_PAGE_SIZE * pool->size));
+			for (int i = ADDITIONAL_DATA_PAGE_SIZE - 1; i >= 0; --i) {
+				pool->free.push_back(pool->capacity + i);
+			}
+			pool->capacity += ADDITIONAL_DATA_PAGE_SIZE;
+		}
+		int block = pool->free[pool->free.size() - 1];
+		pool->free.pop_back();
+		++pool->used;
+		Slot& slot = _slots[idx];
+		slot.pool = p;
+		slot.block = block;
+		return get_block(pool, block);
 	}
 
 	// -----------------------------------------------------
 	// remove
 	// -----------------------------------------------------
 	void AdditionalData::remove(ID sid) {
-		int idx = find_header(sid);
-		//LOGC("World") << "==> removing sid: " << sid << " header index: " << idx;
-		if (idx != -1) {
-			AdditionalDataHeader& header = headers[idx];
-			if (header.used) {
-				header.used = false;
-			}
+		uint32_t idx = sid & INDEX_MASK;
+		if (idx < _slots.size() && _slots[idx].pool != -1) {
+			Slot& slot = _slots[idx];
+			AdditionalDataPool* pool = _pools[slot.pool];
+			pool->free.push_back(slot.block);
+			--pool->used;
+			slot.pool = -1;
+			slot.block = -1;
 		}
 	}
 
@@ -50,12 +67,10 @@ namespace ds {
 	// get
 	// -----------------------------------------------------
 	void* AdditionalData::get(ID sid) {
-		int idx = find_header(sid);
-		if (idx != -1) {
-			const AdditionalDataHeader& header = headers[idx];
-			if (header.used) {
-				return data.data + header.index;
-			}
+		uint32_t idx = sid & INDEX_MASK;
+		if (idx < _slots.size() && _slots[idx].pool != -1) {
+			const Slot& slot = _slots[idx];
+			return get_block(_pools[slot.pool], slot.block);
 		}
 		LOGC("World") << "No data found for: " << sid;
 		debug();
@@ -66,66 +81,67 @@ namespace ds {
 	// contains
 	// -----------------------------------------------------
 	bool AdditionalData::contains(ID sid) {
-		int idx = find_header(sid);
-		if (idx != -1) {
-			const AdditionalDataHeader& header = headers[idx];
-			return header.used;
-		}
-		return false;
+		uint32_t idx = sid & INDEX_MASK;
+		return idx < _slots.size() && _slots[idx].pool != -1;
 	}
 
 	// -----------------------------------------------------
-	// find free header
+	// find pool - there is one pool per identifier and
+	// size. A new one is created if there is none yet.
 	// -----------------------------------------------------
-	int AdditionalData::find_free_header(int size) {
-		for (uint32_t i = 0; i < headers.size(); ++i) {
-			const AdditionalDataHeader& h = headers[i];
-			//if (h.size == size && !h.used) {
-			if (h.size >= size && !h.used) {
+	int AdditionalData::find_pool(int size, int identifier) {
+		for (uint32_t i = 0; i < _pools.size(); ++i) {
+			const AdditionalDataPool* pool = _pools[i];
+			if (pool->identifier == identifier && pool->size == size) {
 				return i;
 			}
 		}
-		return -1;
+		AdditionalDataPool* pool = new AdditionalDataPool;
+		pool->identifier = identifier;
+		pool->size = size;
+		pool->used = 0;
+		pool->capacity = 0;
+		_pools.push_back(pool);
+		return _pools.size() - 1;
 	}
 
-	// -----------------------------------------------------
-	// find header
-	// -----------------------------------------------------
-	int AdditionalData::find_header(ID sid) {
-		for (uint32_t i = 0; i < headers.size(); ++i) {
-			const AdditionalDataHeader& h = headers[i];
-			if (h.sid == sid && h.used ) {
-				return i;
-			}
-		}
-		return -1;
+	char* AdditionalData::get_block(const AdditionalDataPool* pool, int block) const {
+		return pool->pages[block / ADDITIONAL_DATA_PAGE_SIZE] + (block % ADDITIONAL_DATA_PAGE_SIZE) * pool->size;
 	}
 
 	// -----------------------------------------------------
 	// debug
 	// -----------------------------------------------------
 	void AdditionalData::debug() {
-		for (uint32_t i = 0; i < headers.size(); ++i) {
-			const AdditionalDataHeader& h = headers[i];
-			LOG << h.index << " sid: " << h.sid << " size: " << h.size << " used: " << h.used << " identifier: " << h.identifier;
+		for (uint32_t i = 0; i < _pools.size(); ++i) {
+			const AdditionalDataPool* pool = _pools[i];
+			LOG << i << " identifier: " << pool->identifier << " size: " << pool->size << " used: " << pool->used << " capacity: " << pool->capacity;
 		}
 	}
 
 	// -----------------------------------------------------
-	// save report
+	// save report - the fragmentation is the percentage
+	// of allocated blocks that are not used
 	// -----------------------------------------------------
 	void AdditionalData::save(const ReportWriter& writer) {
 		writer.startBox("Additional Data");
-		const char* HEADERS[] = { "Index", "ID", "Size", "Used", "Identifier"};
-		writer.startTable(HEADERS, 5);
-		for (uint32_t i = 0; i < headers.size(); ++i) {
-			const AdditionalDataHeader& h = headers[i];
+		const char* HEADERS[] = { "Identifier", "Size", "Used", "Free", "Capacity", "Pages", "Bytes", "Fragmentation" };
+		writer.startTable(HEADERS, 8);
+		for (uint32_t i = 0; i < _pools.size(); ++i) {
+			const AdditionalDataPool* pool = _pools[i];
 			writer.startRow();
-			writer.addCell(h.index);
-			writer.addCell(h.sid);
-			writer.addCell(h.size);
-			writer.addCell(h.used);
-			writer.addCell(h.identifier);
+			writer.addCell(pool->identifier);
+			writer.addCell(pool->size);
+			writer.addCell(pool->used);
+			writer.addCell(pool->capacity - pool->used);
+			writer.addCell(pool->capacity);
+			writer.addCell(pool->pages.size());
+			writer.addCell(pool->capacity * pool->size);
+			float fragmentation = 0.0f;
+			if (pool->capacity > 0) {
+				fragmentation = (float)(pool->capacity - pool->used) * 100.0f / (float)pool->capacity;
+			}
+			writer.addCell(fragmentation);
 			writer.endRow();
 		}
 		writer.endTable();
@@ -1,23 +1,44 @@
 #pragma once
 #include "..\Common.h"
 #include "..\lib\collection_types.h"
+#include "..\lib\DataArray.h"
 #include "..\io\ReportWriter.h"
 
 namespace ds {
 
-	struct AdditionalDataHeader {
-		int index;
-		int size;
-		bool used;
-		ID sid;
+	// number of blocks per page of a pool
+	const int ADDITIONAL_DATA_PAGE_SIZE = 64;
+
+	// -----------------------------------------------
+	// AdditionalDataPool - fixed size blocks for one
+	// identifier. The blocks are allocated in pages
+	// so a pointer stays valid until the data is 
+	// removed. Free blocks are reused LIFO.
+	// -----------------------------------------------
+	struct AdditionalDataPool {
 		int identifier;
+		int size;
+		Array<char*> pages;
+		Array<int> free;
+		int used;
+		int capacity;
 	};
 
+	// -----------------------------------------------
+	// AdditionalData - one block per entity. The ID
+	// is mapped to the pool and block so attach, get
+	// and remove are O(1).
+	// -----------------------------------------------
 	class AdditionalData {
 
+		struct Slot {
+			int pool;
+			int block;
+		};
+
 	public:
 		AdditionalData() {}
-		~AdditionalData() {}
+		~AdditionalData();
 		void* attach(ID sid, int size,int identifier);
 		void remove(ID sid);
 		void* get(ID sid);
@@ -25,10 +46,10 @@ namespace ds {
 		void debug();
 		void save(const ReportWriter& writer);
 	private:
-		int find_free_header(int size);
-		int find_header(ID sid);
-		CharBuffer data;
-		Array<AdditionalDataHeader> headers;
+		int find_pool(int size, int identifier);
+		char* get_block(const AdditionalDataPool* pool, int block) const;
+		Array<AdditionalDataPool*> _pools;
+		Array<Slot> _slots;
 	};
 
 }
\ No newline at end of file
@@ -1,10 +1,44 @@
 #include "Behaviors.h"
 #include "..\base\Assert.h"
 #include "actions\AbstractAction.h"
+#include "..\math\math.h"
 
 namespace ds {
 
-	Behaviors::Behaviors(ActionManager* actionManager) : _actionManager(actionManager) {
+	// -----------------------------------------------
+	// hash of (from, type, objectType)
+	// -----------------------------------------------
+	static uint32_t transition_key(ID from, int type, int objectType) {
+		uint32_t hash = FNV_Seed;
+		hash = (hash ^ from) * FNV_Prime;
+		hash = (hash ^ (uint32_t)type) * FNV_Prime;
+		hash = (hash ^ (uint32_t)objectType) * FNV_Prime;
+		return hash;
+	}
+
+	// -----------------------------------------------
+	// power of two table size with at least 2 * num slots
+	// -----------------------------------------------
+	static uint32_t table_size(uint32_t num) {
+		uint32_t sz = 16;
+		while (sz < num * 2) {
+			sz *= 2;
+		}
+		return sz;
+	}
+
+	static void clear_table(Array<BehaviorSlot>& table, uint32_t size) {
+		table.clear();
+		BehaviorSlot empty;
+		empty.key = 0;
+		empty.from = INVALID_ID;
+		empty.index = -1;
+		for (uint32_t i = 0; i < size; ++i) {
+			table.push_back(empty);
+		}
+	}
+
+	Behaviors::Behaviors(ActionManager* actionManager, TimerWheel* timers) : _actionManager(actionManager) , _timers(timers) , _compiled(false) {
 	}
 
 
@@ -20,56 +54,170 @@ namespace ds {
 	ID Behaviors::create(const char* name) {
 		Behavior* b = new Behavior;
 		b->hash = SID(name);
+		b->ttl = 0.0f;
+		b->ttlVariance = 0.0f;
 		_behaviors.push_back(b);
+		_compiled = false;
 		return _behaviors.size() - 1;
 	}
 
+	// -----------------------------------------------
+	// set ttl - the behavior will trigger AT_WAIT 
+	// after ttl seconds
+	// -----------------------------------------------
+	void Behaviors::setTTL(ID behaviorID, float ttl, float variance) {
+		Behavior* b = _behaviors[behaviorID];
+		b->ttl = ttl;
+		b->ttlVariance = variance;
+	}
+
 	// -----------------------------------------------
 	// add settings to behavior
 	// -----------------------------------------------
 	void Behaviors::addSettings(ID behaviorID, ActionSettings* settings) {
 		Behavior* b = _behaviors[behaviorID];
 		b->settings.push_back(settings);
+		_compiled = false;
 	}
 
 	// -----------------------------------------------
-	// start behavior
+	// compile - builds the flat settings list and the
+	// lookup tables. Called automatically whenever 
+	// behaviors, settings or transitions have changed.
 	// -----------------------------------------------
-	void Behaviors::start(const StaticHash& hash, ID id) {
-		int idx = -1;
+	void Behaviors::compile() {
+		_settings.clear();
+		_settingsOffsets.clear();
 		for (uint32_t i = 0; i < _behaviors.size(); ++i) {
-			if (_behaviors[i]->hash == hash) {
-				idx = i;
+			_settingsOffsets.push_back(_settings.size());
+			const Behavior* b = _behaviors[i];
+			for (uint32_t j = 0; j < b->settings.size(); ++j) {
+				_settings.push_back(b->settings[j]);
 			}
 		}
-		XASSERT(idx != -1, "Cannot find matching behavior");
-		start(idx, id);
+		_settingsOffsets.push_back(_settings.size());
+		// behaviors by hash - the last one wins
+		clear_table(_behaviorTable, table_size(_behaviors.size()));
+		uint32_t mask = _behaviorTable.size() - 1;
+		for (uint32_t i = 0; i < _behaviors.size(); ++i) {
+			uint32_t key = _behaviors[i]->hash.get();
+			uint32_t slot = key & mask;
+			while (_behaviorTable[slot].index != -1 && _behaviorTable[slot].key != key) {
+				slot = (slot + 1) & mask;
+			}
+			_behaviorTable[slot].key = key;
+			_behaviorTable[slot].index = i;
+		}
+		// every transition is stored with its source behavior
+		// and as fallback for any behavior
+		clear_table(_transitionTable, table_size(_transitions.size() * 2));
+		for (uint32_t i = 0; i < _transitions.size(); ++i) {
+			insertTransition(i, _transitions[i].from);
+			insertTransition(i, INVALID_ID);
+		}
+		_compiled = true;
 	}
 
 	// -----------------------------------------------
-	// tick
+	// insert transition - the first one wins
 	// -----------------------------------------------
-	void Behaviors::tick(float dt) {
-		Array<ActiveBehavior>::iterator it = _activeBehaviors.begin();
-		while (it != _activeBehaviors.end()) {
-			if (it->trigger == BT_TIMER) {
-				it->timer += dt;
-				if (it->timer >= it->ttl) {
-					int tid = findTransition(it->actionType, it->objectType);
-					if (tid != -1) {
-						const BehaviorTransition& t = _transitions[tid];
-						start(t.to, it->reference);
-					}
-					it = _activeBehaviors.remove(it);
-				}
-				else {
-					++it;
+	void Behaviors::insertTransition(int index, ID from) {
+		const BehaviorTransition& t = _transitions[index];
+		uint32_t key = transition_key(from, t.type, t.objectType);
+		uint32_t mask = _transitionTable.size() - 1;
+		uint32_t slot = key & mask;
+		while (_transitionTable[slot].index != -1) {
+			const BehaviorSlot& current = _transitionTable[slot];
+			if (current.key == key && current.from == from) {
+				const BehaviorTransition& other = _transitions[current.index];
+				if (other.type == t.type && other.objectType == t.objectType) {
+					return;
 				}
 			}
-			else {
-				++it;
+			slot = (slot + 1) & mask;
+		}
+		_transitionTable[slot].key = key;
+		_transitionTable[slot].from = from;
+		_transitionTable[slot].index = index;
+	}
+
+	// -----------------------------------------------
+	// find behavior by hash
+	// -----------------------------------------------
+	int Behaviors::findBehavior(const StaticHash& hash) {
+		if (!_compiled) {
+			compile();
+		}
+		uint32_t key = hash.get();
+		uint32_t mask = _behaviorTable.size() - 1;
+		uint32_t slot = key & mask;
+		while (_behaviorTable[slot].index != -1) {
+			if (_behaviorTable[slot].key == key) {
+				return _behaviorTable[slot].index;
 			}
+			slot = (slot + 1) & mask;
+		}
+		return -1;
+	}
+
+	// -----------------------------------------------
+	// start behavior
+	// -----------------------------------------------
+	void Behaviors::start(const StaticHash& hash, ID id) {
+		int idx = findBehavior(hash);
+		XASSERT(idx != -1, "Cannot find matching behavior");
+		start(idx, id);
+	}
+
+	// -----------------------------------------------
+	// on timer - the ttl of an active behavior has 
+	// expired
+	// -----------------------------------------------
+	void Behaviors::onTimer(const TimerEvent& e, int objectType) {
+		int idx = findActive(e.id);
+		if (idx == -1 || _activeBehaviors[idx].timer != e.handle) {
+			return;
+		}
+		_activeBehaviors[idx].timer = INVALID_TIMER;
+		int tid = findTransition(_activeBehaviors[idx].behavior, AT_WAIT, objectType);
+		if (tid != -1) {
+			const BehaviorTransition& t = _transitions[tid];
+			start(t.to, e.id);
+		}
+	}
+
+	// -----------------------------------------------
+	// remove the active behavior of this entity
+	// -----------------------------------------------
+	void Behaviors::removeByID(ID id) {
+		int idx = findActive(id);
+		if (idx != -1) {
+			_timers->cancel(_activeBehaviors[idx].timer);
+			removeActive(idx);
+		}
+	}
+
+	// -----------------------------------------------
+	// find active behavior of entity
+	// -----------------------------------------------
+	int Behaviors::findActive(ID id) const {
+		if (id < _activeIndices.size()) {
+			return _activeIndices[id];
+		}
+		return -1;
+	}
+
+	// -----------------------------------------------
+	// remove active behavior - swaps in the last one
+	// -----------------------------------------------
+	void Behaviors::removeActive(int index) {
+		uint32_t last = _activeBehaviors.size() - 1;
+		_activeIndices[_activeBehaviors[index].reference] = -1;
+		if ((uint32_t)index != last) {
+			_activeBehaviors[index] = _activeBehaviors[last];
+			_activeIndices[_activeBehaviors[index].reference] = index;
 		}
+		_activeBehaviors.pop_back();
 	}
 
 	// -----------------------------------------------
@@ -77,18 +225,41 @@ namespace ds {
 	// -----------------------------------------------
 	void Behaviors::start(int idx, ID id) {
 		if (idx != -1) {
-			Behavior* b = _behaviors[idx];
-			for (uint32_t i = 0; i < b->settings.size(); ++i) {
-				ActionSettings* s = b->settings[i];
+			if (!_compiled) {
+				compile();
+			}
+			for (int i = _settingsOffsets[idx]; i < _settingsOffsets[idx + 1]; ++i) {
+				ActionSettings* s = _settings[i];
 				AbstractAction* action = _actionManager->get(s->type);
 				action->attach(id, s);
 			}
-			ActiveBehavior active;
+			int a = findActive(id);
+			if (a == -1) {
+				while (_activeIndices.size() <= id) {
+					_activeIndices.push_back(-1);
+				}
+				ActiveBehavior active;
+				_activeBehaviors.push_back(active);
+				a = _activeBehaviors.size() - 1;
+				_activeIndices[id] = a;
+			}
+			else {
+				_timers->cancel(_activeBehaviors[a].timer);
+			}
+			const Behavior* b = _behaviors[idx];
+			ActiveBehavior& active = _activeBehaviors[a];
 			active.reference = id;
-			active.timer = 0.0f;
+			active.behavior = idx;
 			active.trigger = BT_NONE;
-			active.ttl = b->ttl;
-			_activeBehaviors.push_back(active);
+			active.ttl = 0.0f;
+			active.actionType = AT_WAIT;
+			active.objectType = -1;
+			active.timer = INVALID_TIMER;
+			if (b->ttl > 0.0f) {
+				active.trigger = BT_TIMER;
+				active.ttl = math::randomRange(b->ttl, b->ttlVariance);
+				active.timer = _timers->schedule(active.ttl, id, TO_BEHAVIOR, idx);
+			}
 		}
 	}
 
@@ -97,21 +268,14 @@ namespace ds {
 	// -----------------------------------------------
 	void Behaviors::connect(StaticHash first, const ActionType& type, StaticHash second, int objectType) {
 		BehaviorTransition transition;
-		ID from = INVALID_ID;
-		ID to = INVALID_ID;
-		for (uint32_t i = 0; i < _behaviors.size(); ++i) {
-			if (_behaviors[i]->hash == first) {
-				from = i;
-			}
-			if (_behaviors[i]->hash == second) {
-				to = i;
-			}
-		}
-		transition.from = from;
-		transition.to = to;
+		int from = findBehavior(first);
+		int to = findBehavior(second);
+		transition.from = from != -1 ? from : INVALID_ID;
+		transition.to = to != -1 ? to : INVALID_ID;
 		transition.type = type;
 		transition.objectType = objectType;
 		_transitions.push_back(transition);
+		_compiled = false;
 	}
 
 	// -----------------------------------------------
@@ -124,16 +288,35 @@ namespace ds {
 		transition.type = type;
 		transition.objectType = objectType;
 		_transitions.push_back(transition);
+		_compiled = false;
 	}
 
 	// -----------------------------------------------
-	// find transition
+	// find transition - tries the transition of the
+	// current behavior first and falls back to the
+	// first transition matching type and object type
 	// -----------------------------------------------
-	ID Behaviors::findTransition(ActionType type, int objectType) {
-		for (uint32_t i = 0; i < _transitions.size(); ++i) {
-			const BehaviorTransition& t = _transitions[i];
-			if (t.type == type && t.objectType == objectType) {
-				return i;
+	ID Behaviors::findTransition(ID from, ActionType type, int objectType) {
+		if (!_compiled) {
+			compile();
+		}
+		uint32_t mask = _transitionTable.size() - 1;
+		for (int pass = 0; pass < 2; ++pass) {
+			ID current = pass == 0 ? from : INVALID_ID;
+			if (pass == 0 && from == INVALID_ID) {
+				continue;
+			}
+			uint32_t key = transition_key(current, type, objectType);
+			uint32_t slot = key & mask;
+			while (_transitionTable[slot].index != -1) {
+				const BehaviorSlot& s = _transitionTable[slot];
+				if (s.key == key && s.from == current) {
+					const BehaviorTransition& t = _transitions[s.index];
+					if (t.type == type && t.objectType == objectType) {
+						return s.index;
+					}
+				}
+				slot = (slot + 1) & mask;
 			}
 		}
 		return -1;
@@ -143,7 +326,12 @@ namespace ds {
 	// process event
 	// -----------------------------------------------
 	void Behaviors::processEvent(const ActionEvent& event) {
-		int tid = findTransition(event.action, event.type);
+		ID from = INVALID_ID;
+		int idx = findActive(event.id);
+		if (idx != -1) {
+			from = _activeBehaviors[idx].behavior;
+		}
+		int tid = findTransition(from, event.action, event.type);
 		if (tid != -1) {
 			const BehaviorTransition& t = _transitions[tid];
 			start(t.to, event.id);
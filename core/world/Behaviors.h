@@ -1,5 +1,6 @@
 #pragma once
 #include "ActionManager.h"
+#include "TimerWheel.h"
 #include "..\lib\collection_types.h"
 //#include "actions\AbstractAction.h"
 #include "..\string\StaticHash.h"
@@ -22,9 +23,10 @@ namespace ds {
 	};
 
 	struct ActiveBehavior {
-		float timer;
+		TimerHandle timer;
 		float ttl;
 		ID reference;
+		ID behavior;
 		BehaviorTrigger trigger;
 		int objectType; //????
 		ActionType actionType;
@@ -59,25 +61,52 @@ namespace ds {
 		int objectType;
 	};
 
+	// -----------------------------------------------
+	// slot of the open addressing tables used to find
+	// behaviors by hash and transitions by 
+	// (from, type, objectType)
+	// -----------------------------------------------
+	struct BehaviorSlot {
+		uint32_t key;
+		ID from;
+		int index;
+	};
+
 	class Behaviors {
 
 	public:
-		Behaviors(ActionManager* actionManager);
+		Behaviors(ActionManager* actionManager, TimerWheel* timers);
 		~Behaviors();
 		ID create(const char* name);
-		void tick(float dt);
+		void setTTL(ID behaviorID, float ttl, float variance = 0.0f);
 		void addSettings(ID behaviorID, ActionSettings* settings);
 		void start(const StaticHash& hash, ID id);
 		void connect(ID first, const ActionType& type, ID second, int objectType);
 		void connect(StaticHash first, const ActionType& type, StaticHash second, int objectType);
 		void processEvent(const ActionEvent& event);
+		void onTimer(const TimerEvent& e, int objectType);
+		void removeByID(ID id);
+		void compile();
 	private:
 		void start(int index, ID id);
-		ID findTransition(ActionType type, int objectType);
+		int findBehavior(const StaticHash& hash);
+		ID findTransition(ID from, ActionType type, int objectType);
+		int findActive(ID id) const;
+		void removeActive(int index);
+		void insertTransition(int index, ID from);
 		ActionManager* _actionManager;
+		TimerWheel* _timers;
 		Array<Behavior*> _behaviors;
 		Array<BehaviorTransition> _transitions;
 		Array<ActiveBehavior> _activeBehaviors;
+		// compiled tables
+		bool _compiled;
+		Array<ActionSettings*> _settings;
+		Array<int> _settingsOffsets;
+		Array<BehaviorSlot> _behaviorTable;
+		Array<BehaviorSlot> _transitionTable;
+		// entity ID -> index in _activeBehaviors
+		Array<int> _activeIndices;
 	};
 
 }
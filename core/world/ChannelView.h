@@ -0,0 +1,134 @@
+#pragma once
+#include "..\lib\BlockArray.h"
+#include "..\lib\ArchetypeStorage.h"
+
+namespace ds {
+
+	// -----------------------------------------------
+	// unique key per type for custom channels
+	// -----------------------------------------------
+	template<class T>
+	struct CustomChannelType {
+		static char key;
+	};
+
+	template<class T>
+	char CustomChannelType<T>::key;
+
+	// -----------------------------------------------
+	// ChannelView - iterates over all entities that
+	// have a value in a custom channel. With a 
+	// ChannelArray the dense rows without the presence
+	// bit are skipped. With an ArchetypeStorage it 
+	// walks the chunks of all archetypes containing
+	// the component. The view is invalid after adding
+	// or removing entities or components.
+	// -----------------------------------------------
+	template<class T>
+	class ChannelView {
+
+	public:
+		ChannelView(ChannelArray* data, int channel, int presence, uint32_t bit) : _data((T*)data->get_ptr(channel)), _present((const uint32_t*)data->get_ptr(presence)), _ids((const ID*)data->_dense), _bit(bit), _size(data->size), _storage(0), _component(0) {
+		}
+
+		ChannelView(const ArchetypeStorage* storage, int component) : _data(0), _present(0), _ids(0), _bit(0), _size(0), _storage(storage), _component(component) {
+		}
+
+		class iterator {
+		public:
+			iterator(const ChannelView* view, bool end) : _view(view), _archetype(0), _chunk(0), _row(0), _values(view->_data), _ids(view->_ids), _size(view->_size) {
+				if (view->_storage != 0) {
+					if (end) {
+						_archetype = view->_storage->numArchetypes();
+						_size = 0;
+					}
+					else {
+						_chunk = -1;
+						nextChunk();
+					}
+				}
+				else {
+					_row = end ? _size : 0;
+					skip();
+				}
+			}
+			iterator& operator++() {
+				++_row;
+				if (_view->_storage != 0) {
+					if (_row >= _size) {
+						nextChunk();
+					}
+				}
+				else {
+					skip();
+				}
+				return *this;
+			}
+			T& operator*() const {
+				return _values[_row];
+			}
+			T* operator->() const {
+				return &_values[_row];
+			}
+			ID id() const {
+				return _ids[_row];
+			}
+			bool operator==(const iterator& rhs) const {
+				return _row == rhs._row && _chunk == rhs._chunk && _archetype == rhs._archetype;
+			}
+			bool operator!=(const iterator& rhs) const {
+				return !(*this == rhs);
+			}
+		private:
+			void skip() {
+				while (_row < _size && (_view->_present[_row] & _view->_bit) == 0) {
+					++_row;
+				}
+			}
+			// moves to the next chunk containing the component - chunks are never empty
+			void nextChunk() {
+				const ArchetypeStorage* storage = _view->_storage;
+				uint32_t mask = 1u << _view->_component;
+				_row = 0;
+				++_chunk;
+				while (_archetype < (int)storage->numArchetypes()) {
+					if ((storage->getMask(_archetype) & mask) != 0 && _chunk < storage->numChunks(_archetype)) {
+						ArchetypeChunk* chunk = storage->getChunk(_archetype, _chunk);
+						_values = chunk->get<T>(_view->_component);
+						_ids = chunk->ids;
+						_size = chunk->size;
+						return;
+					}
+					++_archetype;
+					_chunk = 0;
+				}
+				_size = 0;
+			}
+			const ChannelView* _view;
+			int _archetype;
+			int _chunk;
+			int _row;
+			T* _values;
+			const ID* _ids;
+			int _size;
+		};
+
+		iterator begin() const {
+			return iterator(this, false);
+		}
+
+		iterator end() const {
+			return iterator(this, true);
+		}
+
+	private:
+		T* _data;
+		const uint32_t* _present;
+		const ID* _ids;
+		uint32_t _bit;
+		int _size;
+		const ArchetypeStorage* _storage;
+		int _component;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "DirtyChannels.h"
+#include "..\memory\DefaultAllocator.h"
+#include <string.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ds {
+
+	// -----------------------------------------------
+	// index of the lowest set bit
+	// -----------------------------------------------
+	static int lowest_bit(uint32_t v) {
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, v);
+		return (int)index;
+#else
+		return __builtin_ctz(v);
+#endif
+	}
+
+	DirtyChannels::DirtyChannels() : _words(0), _tracked(0) {
+		for (int i = 0; i < MAX_BLOCKS; ++i) {
+			_current[i] = 0;
+			_published[i] = 0;
+		}
+	}
+
+	DirtyChannels::~DirtyChannels() {
+		for (int i = 0; i < MAX_BLOCKS; ++i) {
+			if (_current[i] != 0) {
+				DEALLOC(_current[i]);
+				DEALLOC(_published[i]);
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// track - channels is a mask of WorldEntityChannels
+	// -----------------------------------------------
+	void DirtyChannels::track(uint32_t channels) {
+		_tracked = channels;
+		uint32_t words = _words;
+		_words = 0;
+		for (int i = 0; i < MAX_BLOCKS; ++i) {
+			if (_current[i] != 0) {
+				DEALLOC(_current[i]);
+				DEALLOC(_published[i]);
+				_current[i] = 0;
+				_published[i] = 0;
+			}
+		}
+		if (words > 0) {
+			grow(words);
+		}
+	}
+
+	// -----------------------------------------------
+	// grow - both bitsets of all tracked channels
+	// -----------------------------------------------
+	void DirtyChannels::grow(uint32_t words) {
+		for (int i = 0; i < MAX_BLOCKS; ++i) {
+			if ((_tracked & (1 << i)) != 0) {
+				uint32_t* current = (uint32_t*)ALLOC(words * sizeof(uint32_t));
+				uint32_t* published = (uint32_t*)ALLOC(words * sizeof(uint32_t));
+				memset(current, 0, words * sizeof(uint32_t));
+				memset(published, 0, words * sizeof(uint32_t));
+				if (_current[i] != 0) {
+					memcpy(current, _current[i], _words * sizeof(uint32_t));
+					memcpy(published, _published[i], _words * sizeof(uint32_t));
+					DEALLOC(_current[i]);
+					DEALLOC(_published[i]);
+				}
+				_current[i] = current;
+				_published[i] = published;
+			}
+		}
+		_words = words;
+	}
+
+	void DirtyChannels::markTracked(uint32_t index, uint32_t channels) {
+		uint32_t word = index >> 5;
+		if (word >= _words) {
+			grow(word * 2 + 8);
+		}
+		uint32_t bit = 1u << (index & 31);
+		while (channels != 0) {
+			int channel = lowest_bit(channels);
+			_current[channel][word] |= bit;
+			channels &= channels - 1;
+		}
+	}
+
+	// -----------------------------------------------
+	// remove - a removed entity is not reported
+	// -----------------------------------------------
+	void DirtyChannels::remove(ID id) {
+		uint32_t index = id & INDEX_MASK;
+		uint32_t word = index >> 5;
+		if (word < _words) {
+			uint32_t mask = ~(1u << (index & 31));
+			for (int i = 0; i < MAX_BLOCKS; ++i) {
+				if (_current[i] != 0) {
+					_current[i][word] &= mask;
+					_published[i][word] &= mask;
+				}
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// publish - swaps the bitsets and clears the new
+	// current ones
+	// -----------------------------------------------
+	void DirtyChannels::publish() {
+		for (int i = 0; i < MAX_BLOCKS; ++i) {
+			if (_current[i] != 0) {
+				uint32_t* t = _published[i];
+				_published[i] = _current[i];
+				_current[i] = t;
+				memset(t, 0, _words * sizeof(uint32_t));
+			}
+		}
+	}
+
+	bool DirtyChannels::isDirty(ID id, int channel) const {
+		uint32_t index = id & INDEX_MASK;
+		uint32_t word = index >> 5;
+		if (_published[channel] == 0 || word >= _words) {
+			return false;
+		}
+		return (_published[channel][word] & (1u << (index & 31))) != 0;
+	}
+
+	// -----------------------------------------------
+	// get - writes the IDs of all entities that have
+	// changed the channel in the published frame
+	// -----------------------------------------------
+	int DirtyChannels::get(int channel, ID* ids, int max) const {
+		const uint32_t* bits = _published[channel];
+		if (bits == 0) {
+			return 0;
+		}
+		int cnt = 0;
+		for (uint32_t i = 0; i < _words && cnt < max; ++i) {
+			uint32_t w = bits[i];
+			while (w != 0 && cnt < max) {
+				ids[cnt++] = (i << 5) + lowest_bit(w);
+				w &= w - 1;
+			}
+		}
+		return cnt;
+	}
+
+}
\ No newline at end of file
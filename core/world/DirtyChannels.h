@@ -0,0 +1,52 @@
+#pragma once
+#include "..\Common.h"
+#include "..\lib\DataArray.h"
+#include "..\lib\BlockArray.h"
+
+namespace ds {
+
+	// -----------------------------------------------
+	// DirtyChannels - one bit per entity and tracked
+	// channel. The bits are collected during a frame
+	// and published at the end of World::tick. The
+	// published bits stay valid until the next tick
+	// so consumers can process only changed entities.
+	// Changes made between two ticks show up in the
+	// next published frame.
+	// -----------------------------------------------
+	class DirtyChannels {
+
+	public:
+		DirtyChannels();
+		~DirtyChannels();
+		void track(uint32_t channels);
+		uint32_t getTracked() const {
+			return _tracked;
+		}
+		void mark(ID id, uint32_t channels) {
+			uint32_t tracked = channels & _tracked;
+			if (tracked != 0) {
+				markTracked(id & INDEX_MASK, tracked);
+			}
+		}
+		void remove(ID id);
+		void publish();
+		// queries on the published frame
+		bool isDirty(ID id, int channel) const;
+		int get(int channel, ID* ids, int max) const;
+		const uint32_t* getBits(int channel) const {
+			return _published[channel];
+		}
+		uint32_t getNumWords() const {
+			return _words;
+		}
+	private:
+		void markTracked(uint32_t index, uint32_t channels);
+		void grow(uint32_t words);
+		uint32_t* _current[MAX_BLOCKS];
+		uint32_t* _published[MAX_BLOCKS];
+		uint32_t _words;
+		uint32_t _tracked;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "EntityChannels.h"
+#include "actions\AbstractAction.h"
+#include <string.h>
+
+namespace ds {
+
+	namespace channels {
+
+		// -----------------------------------------------
+		// to half - rounds to nearest. Values out of range
+		// become infinity and tiny values become 0.
+		// -----------------------------------------------
+		uint16_t to_half(float v) {
+			uint32_t x;
+			memcpy(&x, &v, sizeof(float));
+			uint32_t sign = (x >> 16) & 0x8000;
+			uint32_t exponent = (x >> 23) & 0xff;
+			uint32_t mantissa = x & 0x7fffff;
+			if (exponent == 0xff) {
+				return (uint16_t)(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+			}
+			int e = (int)exponent - 127 + 15;
+			if (e >= 31) {
+				return (uint16_t)(sign | 0x7c00);
+			}
+			if (e <= 0) {
+				if (e < -10) {
+					return (uint16_t)sign;
+				}
+				mantissa |= 0x800000;
+				int shift = 14 - e;
+				uint32_t h = mantissa >> shift;
+				if ((mantissa >> (shift - 1)) & 1) {
+					++h;
+				}
+				return (uint16_t)(sign | h);
+			}
+			uint32_t h = sign | (e << 10) | (mantissa >> 13);
+			// a carry into the exponent is still correct
+			if (mantissa & 0x1000) {
+				++h;
+			}
+			return (uint16_t)h;
+		}
+
+		float from_half(uint16_t h) {
+			uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+			uint32_t exponent = (h >> 10) & 0x1f;
+			uint32_t mantissa = h & 0x3ff;
+			uint32_t x;
+			if (exponent == 0) {
+				if (mantissa == 0) {
+					x = sign;
+				}
+				else {
+					// subnormal - normalize the mantissa
+					exponent = 127 - 15 + 1;
+					while ((mantissa & 0x400) == 0) {
+						mantissa <<= 1;
+						--exponent;
+					}
+					mantissa &= 0x3ff;
+					x = sign | (exponent << 23) | (mantissa << 13);
+				}
+			}
+			else if (exponent == 31) {
+				x = sign | 0x7f800000 | (mantissa << 13);
+			}
+			else {
+				x = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+			}
+			float v;
+			memcpy(&v, &x, sizeof(float));
+			return v;
+		}
+
+		Color unpack(uint32_t c) {
+			const float s = 1.0f / 255.0f;
+			return Color((float)(c & 0xff) * s, (float)((c >> 8) & 0xff) * s, (float)((c >> 16) & 0xff) * s, (float)(c >> 24) * s);
+		}
+
+		// -----------------------------------------------
+		// init - the channel layout of a World. Name and
+		// hash are only used for lookups and reports.
+		// -----------------------------------------------
+		void init(ChannelArray* data, WorldStorage storage, TextureTable* textures) {
+			uint32_t cold = WEC_MASK(WEC_NAME) | WEC_MASK(WEC_HASH);
+			if (storage == WS_COMPACT) {
+				data->textures = textures;
+				int sizes[] = { sizeof(v3), sizeof(half3), sizeof(float), sizeof(uint16_t), sizeof(uint32_t), sizeof(float), sizeof(int16_t), sizeof(v3), sizeof(int), sizeof(StaticHash) };
+				data->init(sizes, 10, cold);
+			}
+			else {
+				int sizes[] = { sizeof(v3), sizeof(v3), sizeof(v3), sizeof(Texture), sizeof(Color), sizeof(float), sizeof(int), sizeof(v3), sizeof(int), sizeof(StaticHash) };
+				data->init(sizes, 10, cold);
+			}
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#pragma once
+#include "World.h"
+#include "SpriteExtraction.h"
+#include "TextureTable.h"
+
+namespace ds {
+
+	struct half3 {
+		uint16_t x;
+		uint16_t y;
+		uint16_t z;
+	};
+
+	// -----------------------------------------------
+	// channels - accessors for the channels that have
+	// a compact format. The format is taken from the
+	// size of the type channel. Everything reading or
+	// writing scale, rotation, texture, color or type
+	// has to use them. Compact textures are looked up
+	// in the texture table of the world.
+	// -----------------------------------------------
+	namespace channels {
+
+		uint16_t to_half(float v);
+
+		float from_half(uint16_t h);
+
+		Color unpack(uint32_t c);
+
+		// the table is only used by WS_COMPACT and has to outlive the array
+		void init(ChannelArray* data, WorldStorage storage, TextureTable* textures);
+
+		inline bool isCompact(const ChannelArray* data) {
+			return data->_sizes[WEC_TYPE] == sizeof(int16_t);
+		}
+
+		// by dense row
+		inline v3 scaleAt(const ChannelArray* data, int row) {
+			if (isCompact(data)) {
+				const half3& h = ((const half3*)data->get_ptr(WEC_SCALE))[row];
+				return v3(from_half(h.x), from_half(h.y), from_half(h.z));
+			}
+			return ((const v3*)data->get_ptr(WEC_SCALE))[row];
+		}
+
+		inline float rotationAt(const ChannelArray* data, int row) {
+			if (isCompact(data)) {
+				return ((const float*)data->get_ptr(WEC_ROTATION))[row];
+			}
+			return ((const v3*)data->get_ptr(WEC_ROTATION))[row].x;
+		}
+
+		inline const Texture& textureAt(const ChannelArray* data, int row) {
+			if (isCompact(data)) {
+				return data->textures->get(((const uint16_t*)data->get_ptr(WEC_TEXTURE))[row]);
+			}
+			return ((const Texture*)data->get_ptr(WEC_TEXTURE))[row];
+		}
+
+		inline int typeAt(const ChannelArray* data, int row) {
+			if (isCompact(data)) {
+				return ((const int16_t*)data->get_ptr(WEC_TYPE))[row];
+			}
+			return ((const int*)data->get_ptr(WEC_TYPE))[row];
+		}
+
+		// by ID
+		inline v3 getScale(const ChannelArray* data, ID id) {
+			return scaleAt(data, data->row(id, WEC_SCALE));
+		}
+
+		inline void setScale(ChannelArray* data, ID id, const v3& s) {
+			if (isCompact(data)) {
+				half3 h = { to_half(s.x), to_half(s.y), to_half(s.z) };
+				data->set<half3>(id, WEC_SCALE, h);
+			}
+			else {
+				data->set<v3>(id, WEC_SCALE, s);
+			}
+		}
+
+		// compact storage keeps only the angle around z - the other components are 0
+		inline v3 getRotation(const ChannelArray* data, ID id) {
+			if (isCompact(data)) {
+				return v3(data->get<float>(id, WEC_ROTATION), 0.0f, 0.0f);
+			}
+			return data->get<v3>(id, WEC_ROTATION);
+		}
+
+		inline void setRotation(ChannelArray* data, ID id, const v3& r) {
+			if (isCompact(data)) {
+				data->set<float>(id, WEC_ROTATION, r.x);
+			}
+			else {
+				data->set<v3>(id, WEC_ROTATION, r);
+			}
+		}
+
+		inline const Texture& getTexture(const ChannelArray* data, ID id) {
+			return textureAt(data, data->row(id, WEC_TEXTURE));
+		}
+
+		inline void setTexture(ChannelArray* data, ID id, const Texture& t) {
+			if (isCompact(data)) {
+				data->set<uint16_t>(id, WEC_TEXTURE, data->textures->add(t));
+			}
+			else {
+				data->set(id, WEC_TEXTURE, t);
+			}
+		}
+
+		inline Color getColor(const ChannelArray* data, ID id) {
+			if (isCompact(data)) {
+				return unpack(data->get<uint32_t>(id, WEC_COLOR));
+			}
+			return data->get<Color>(id, WEC_COLOR);
+		}
+
+		inline void setColor(ChannelArray* data, ID id, const Color& c) {
+			if (isCompact(data)) {
+				data->set<uint32_t>(id, WEC_COLOR, sprites::pack(c));
+			}
+			else {
+				data->set<Color>(id, WEC_COLOR, c);
+			}
+		}
+
+		inline int getType(const ChannelArray* data, ID id) {
+			return typeAt(data, data->row(id, WEC_TYPE));
+		}
+
+		inline void setType(ChannelArray* data, ID id, int type) {
+			if (isCompact(data)) {
+				data->set<int16_t>(id, WEC_TYPE, (int16_t)type);
+			}
+			else {
+				data->set<int>(id, WEC_TYPE, type);
+			}
+		}
+
+		// writes a v3 into any channel - used by actions with a configurable channel
+		inline void set(ChannelArray* data, ID id, int channel, const v3& v) {
+			if (channel == WEC_SCALE) {
+				setScale(data, id, v);
+			}
+			else if (channel == WEC_ROTATION) {
+				setRotation(data, id, v);
+			}
+			else {
+				data->set<v3>(id, channel, v);
+			}
+		}
+
+	}
+
+}
\ No newline at end of file
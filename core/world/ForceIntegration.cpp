@@ -0,0 +1,93 @@
+#include "ForceIntegration.h"
+#if defined(__AVX__)
+#define DS_FORCES_AVX
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DS_FORCES_SSE
+#include <emmintrin.h>
+#endif
+
+namespace ds {
+
+	namespace forces {
+
+		// -----------------------------------------------
+		// write moved - m holds one bit per float of the
+		// rows so every row owns three consecutive bits
+		// -----------------------------------------------
+		static void writeMoved(uint8_t* moved, uint32_t m, int rows) {
+			for (int j = 0; j < rows; ++j) {
+				moved[j] = ((m >> (j * 3)) & 7) != 0 ? 1 : 0;
+			}
+		}
+
+		// -----------------------------------------------
+		// apply - the v3 channels are treated as float 
+		// streams. A block of 4 (SSE) or 8 (AVX) rows 
+		// fills exactly three registers so no transpose 
+		// is needed.
+		// -----------------------------------------------
+		void apply(v3* positions, const v3* forces, int num, uint8_t* moved) {
+			float* p = &positions[0].x;
+			const float* f = &forces[0].x;
+			int i = 0;
+#ifdef DS_FORCES_AVX
+			__m256 zero = _mm256_setzero_ps();
+			for (; i + 8 <= num; i += 8) {
+				float* pp = p + i * 3;
+				const float* fp = f + i * 3;
+				__m256 f0 = _mm256_loadu_ps(fp);
+				__m256 f1 = _mm256_loadu_ps(fp + 8);
+				__m256 f2 = _mm256_loadu_ps(fp + 16);
+				_mm256_storeu_ps(pp, _mm256_add_ps(_mm256_loadu_ps(pp), f0));
+				_mm256_storeu_ps(pp + 8, _mm256_add_ps(_mm256_loadu_ps(pp + 8), f1));
+				_mm256_storeu_ps(pp + 16, _mm256_add_ps(_mm256_loadu_ps(pp + 16), f2));
+				if (moved != 0) {
+					uint32_t m = (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(f0, zero, _CMP_NEQ_UQ));
+					m |= (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(f1, zero, _CMP_NEQ_UQ)) << 8;
+					m |= (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(f2, zero, _CMP_NEQ_UQ)) << 16;
+					writeMoved(moved + i, m, 8);
+				}
+			}
+#endif
+#ifdef DS_FORCES_SSE
+			__m128 zero = _mm_setzero_ps();
+			for (; i + 4 <= num; i += 4) {
+				float* pp = p + i * 3;
+				const float* fp = f + i * 3;
+				__m128 f0 = _mm_loadu_ps(fp);
+				__m128 f1 = _mm_loadu_ps(fp + 4);
+				__m128 f2 = _mm_loadu_ps(fp + 8);
+				_mm_storeu_ps(pp, _mm_add_ps(_mm_loadu_ps(pp), f0));
+				_mm_storeu_ps(pp + 4, _mm_add_ps(_mm_loadu_ps(pp + 4), f1));
+				_mm_storeu_ps(pp + 8, _mm_add_ps(_mm_loadu_ps(pp + 8), f2));
+				if (moved != 0) {
+					uint32_t m = (uint32_t)_mm_movemask_ps(_mm_cmpneq_ps(f0, zero));
+					m |= (uint32_t)_mm_movemask_ps(_mm_cmpneq_ps(f1, zero)) << 4;
+					m |= (uint32_t)_mm_movemask_ps(_mm_cmpneq_ps(f2, zero)) << 8;
+					writeMoved(moved + i, m, 4);
+				}
+			}
+#endif
+			for (; i < num; ++i) {
+				const v3& force = forces[i];
+				if (moved != 0) {
+					moved[i] = (force.x != 0.0f || force.y != 0.0f || force.z != 0.0f) ? 1 : 0;
+				}
+				positions[i] += force;
+			}
+		}
+
+		bool any(const v3* forces, int num) {
+			for (int i = 0; i < num; ++i) {
+				const v3& f = forces[i];
+				if (f.x != 0.0f || f.y != 0.0f || f.z != 0.0f) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+#include "..\Common.h"
+#include "..\math\math_types.h"
+
+namespace ds {
+
+	namespace forces {
+
+		// adds the forces of the first num rows to the positions. The forces are kept
+		// until the world resets them at the start of the next tick. If moved is not 
+		// null it receives 1 for every row with a non zero force and 0 for all others.
+		void apply(v3* positions, const v3* forces, int num, uint8_t* moved = 0);
+
+		// returns true if any of the first num forces is not zero
+		bool any(const v3* forces, int num);
+
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "SpriteExtraction.h"
+#include "World.h"
+#include "EntityChannels.h"
+#include "..\lib\RadixSort.h"
+#include <math.h>
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DS_EXTRACT_SSE
+#include <emmintrin.h>
+#endif
+
+namespace ds {
+
+	namespace sprites {
+
+		// -----------------------------------------------
+		// pack color into RGBA8
+		// -----------------------------------------------
+		uint32_t pack(const Color& color) {
+#ifdef DS_EXTRACT_SSE
+			__m128 c = _mm_loadu_ps(color.values);
+			c = _mm_min_ps(_mm_max_ps(c, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+			c = _mm_add_ps(_mm_mul_ps(c, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+			__m128i ci = _mm_cvttps_epi32(c);
+			ci = _mm_packs_epi32(ci, ci);
+			ci = _mm_packus_epi16(ci, ci);
+			return (uint32_t)_mm_cvtsi128_si32(ci);
+#else
+			uint32_t ret = 0;
+			for (int i = 0; i < 4; ++i) {
+				float v = color.values[i];
+				v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+				ret |= (uint32_t)(v * 255.0f + 0.5f) << (i * 8);
+			}
+			return ret;
+#endif
+		}
+
+		static void write(SpriteInstance* out, const v3& p, const v3& s, float r, const Texture& t, uint32_t c) {
+			out->position = v2(p.x, p.y);
+			out->scale = v2(s.x, s.y);
+			out->rotation = r;
+			out->uv = v4(t.uv[0].x, t.uv[0].y, t.uv[2].x, t.uv[2].y);
+			out->color = c;
+		}
+
+		// -----------------------------------------------
+		// draw key - the texture id in the upper bits and
+		// the source rect hashed into the lower 16 bits so
+		// sprites of the same atlas region are batched
+		// -----------------------------------------------
+		static uint64_t key(int type, const v3& p, const Texture& t) {
+			uint32_t r = (uint32_t)(int)t.rect.left * 31u + (uint32_t)(int)t.rect.top;
+			r = r * 31u + (uint32_t)(int)t.rect.width() * 7u + (uint32_t)(int)t.rect.height();
+			uint32_t texture = ((uint32_t)(t.textureID & 0xff) << 16) | (r & 0xffff);
+			return sort::sprite_key(type, texture, p.z);
+		}
+
+		// -----------------------------------------------
+		// extract compact - decodes the half scales and
+		// looks up the texture table. The colors are 
+		// already stored as RGBA8.
+		// -----------------------------------------------
+		static int extractCompact(ChannelArray* data, SpriteInstance* out, int max, float minX, float maxX, float minY, float maxY, uint64_t* keys) {
+			const v3* positions = (const v3*)data->get_ptr(WEC_POSITION);
+			const uint32_t* colors = (const uint32_t*)data->get_ptr(WEC_COLOR);
+			int num = 0;
+			for (int i = 0; i < data->size && num < max; ++i) {
+				const Texture& t = channels::textureAt(data, i);
+				v3 s = channels::scaleAt(data, i);
+				float w = t.dim.x * s.x * 0.5f;
+				float h = t.dim.y * s.y * 0.5f;
+				float radius = sqrtf(w * w + h * h);
+				const v3& p = positions[i];
+				if (p.x + radius >= minX && p.x - radius <= maxX && p.y + radius >= minY && p.y - radius <= maxY) {
+					write(out + num, p, s, channels::rotationAt(data, i), t, colors[i]);
+					if (keys != 0) {
+						keys[num] = key(channels::typeAt(data, i), p, t);
+					}
+					++num;
+				}
+			}
+			return num;
+		}
+
+		// -----------------------------------------------
+		// extract - one pass over the dense channels. An
+		// entity is culled by the circle around its
+		// scaled texture so rotation does not matter.
+		// -----------------------------------------------
+		int extract(ChannelArray* data, SpriteInstance* out, int max, const Rect& view, uint64_t* keys) {
+			float minX = view.left < view.right ? view.left : view.right;
+			float maxX = view.left < view.right ? view.right : view.left;
+			float minY = view.bottom < view.top ? view.bottom : view.top;
+			float maxY = view.bottom < view.top ? view.top : view.bottom;
+			if (channels::isCompact(data)) {
+				return extractCompact(data, out, max, minX, maxX, minY, maxY, keys);
+			}
+			const v3* positions = (const v3*)data->get_ptr(WEC_POSITION);
+			const v3* scales = (const v3*)data->get_ptr(WEC_SCALE);
+			const v3* rotations = (const v3*)data->get_ptr(WEC_ROTATION);
+			const Texture* textures = (const Texture*)data->get_ptr(WEC_TEXTURE);
+			const Color* colors = (const Color*)data->get_ptr(WEC_COLOR);
+			const int* types = (const int*)data->get_ptr(WEC_TYPE);
+			int num = 0;
+			int size = data->size;
+			int i = 0;
+#ifdef DS_EXTRACT_SSE
+			__m128 half = _mm_set1_ps(0.5f);
+			__m128 vminX = _mm_set1_ps(minX);
+			__m128 vmaxX = _mm_set1_ps(maxX);
+			__m128 vminY = _mm_set1_ps(minY);
+			__m128 vmaxY = _mm_set1_ps(maxY);
+			for (; i + 4 <= size && num < max; i += 4) {
+				__m128 px = _mm_set_ps(positions[i + 3].x, positions[i + 2].x, positions[i + 1].x, positions[i].x);
+				__m128 py = _mm_set_ps(positions[i + 3].y, positions[i + 2].y, positions[i + 1].y, positions[i].y);
+				__m128 w = _mm_mul_ps(_mm_set_ps(textures[i + 3].dim.x, textures[i + 2].dim.x, textures[i + 1].dim.x, textures[i].dim.x), _mm_set_ps(scales[i + 3].x, scales[i + 2].x, scales[i + 1].x, scales[i].x));
+				__m128 h = _mm_mul_ps(_mm_set_ps(textures[i + 3].dim.y, textures[i + 2].dim.y, textures[i + 1].dim.y, textures[i].dim.y), _mm_set_ps(scales[i + 3].y, scales[i + 2].y, scales[i + 1].y, scales[i].y));
+				w = _mm_mul_ps(w, half);
+				h = _mm_mul_ps(h, half);
+				__m128 radius = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(w, w), _mm_mul_ps(h, h)));
+				__m128 inside = _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(px, radius), vminX), _mm_cmple_ps(_mm_sub_ps(px, radius), vmaxX));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(py, radius), vminY));
+				inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_sub_ps(py, radius), vmaxY));
+				int mask = _mm_movemask_ps(inside);
+				for (int j = 0; j < 4 && mask != 0; ++j, mask >>= 1) {
+					if ((mask & 1) != 0 && num < max) {
+						int k = i + j;
+						write(out + num, positions[k], scales[k], rotations[k].x, textures[k], pack(colors[k]));
+						if (keys != 0) {
+							keys[num] = key(types[k], positions[k], textures[k]);
+						}
+						++num;
+					}
+				}
+			}
+#endif
+			for (; i < size && num < max; ++i) {
+				float w = textures[i].dim.x * scales[i].x;
+				float h = textures[i].dim.y * scales[i].y;
+				w = w * 0.5f;
+				h = h * 0.5f;
+				float radius = sqrtf(w * w + h * h);
+				const v3& p = positions[i];
+				if (p.x + radius >= minX && p.x - radius <= maxX && p.y + radius >= minY && p.y - radius <= maxY) {
+					write(out + num, p, scales[i], rotations[i].x, textures[i], pack(colors[i]));
+					if (keys != 0) {
+						keys[num] = key(types[i], p, textures[i]);
+					}
+					++num;
+				}
+			}
+			return num;
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include "..\lib\BlockArray.h"
+
+namespace ds {
+
+	// -----------------------------------------------
+	// SpriteInstance - packed per instance data ready
+	// for upload. uv = u0, v0, u1, v1 and color is 
+	// RGBA8 with red in the lowest byte.
+	// -----------------------------------------------
+	struct SpriteInstance {
+		v2 position;
+		v2 scale;
+		float rotation;
+		v4 uv;
+		uint32_t color;
+	};
+
+	namespace sprites {
+
+		// writes all entities overlapping the view and returns the number of instances.
+		// If keys is not null it receives a draw order key per instance (type as layer,
+		// texture and depth) which can be sorted by RadixSort.
+		int extract(ChannelArray* data, SpriteInstance* out, int max, const Rect& view, uint64_t* keys = 0);
+
+		uint32_t pack(const Color& color);
+
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "StorageBenchmark.h"
+#include "World.h"
+#include "..\profiler\Profiler.h"
+
+namespace ds {
+
+	namespace benchmark {
+
+		struct BenchmarkHealth {
+			float value;
+		};
+
+		struct BenchmarkVelocity {
+			v3 value;
+		};
+
+		struct StorageTimes {
+			float set;
+			float iterate;
+			float detach;
+			// sum of all visited values so the loop cannot be dropped
+			float checksum;
+		};
+
+		// -----------------------------------------------
+		// run - set both channels, iterate the first one
+		// and detach the second one again
+		// -----------------------------------------------
+		static StorageTimes run(WorldStorage storage, int num, int iterations) {
+			World world(storage);
+			world.registerChannel<BenchmarkHealth>("health");
+			world.registerChannel<BenchmarkVelocity>("velocity");
+			Array<ID> ids;
+			for (int i = 0; i < num; ++i) {
+				ids.push_back(world.create());
+			}
+			StorageTimes times;
+			StopWatch watch;
+			watch.start();
+			for (int i = 0; i < num; ++i) {
+				BenchmarkHealth h = { 100.0f };
+				world.set(ids[i], h);
+				if ((i & 1) == 0) {
+					BenchmarkVelocity v = { v3(1.0f, 0.0f, 0.0f) };
+					world.set(ids[i], v);
+				}
+			}
+			watch.end();
+			times.set = (float)watch.elapsedMS();
+			times.checksum = 0.0f;
+			watch.start();
+			for (int j = 0; j < iterations; ++j) {
+				ChannelView<BenchmarkHealth> view = world.view<BenchmarkHealth>();
+				for (ChannelView<BenchmarkHealth>::iterator it = view.begin(); it != view.end(); ++it) {
+					it->value -= 0.5f;
+					times.checksum += it->value;
+				}
+			}
+			watch.end();
+			times.iterate = (float)watch.elapsedMS() / (float)iterations;
+			watch.start();
+			for (int i = 0; i < num; i += 2) {
+				world.detach<BenchmarkVelocity>(ids[i]);
+			}
+			watch.end();
+			times.detach = (float)watch.elapsedMS();
+			return times;
+		}
+
+		void compareStorage(const ReportWriter& writer, int num, int iterations) {
+			const char* HEADERS[] = { "Storage", "Entities", "Set (ms)", "Iterate (ms)", "Detach (ms)", "Checksum" };
+			const char* NAMES[] = { "WS_FULL", "WS_ARCHETYPE" };
+			WorldStorage storages[] = { WS_FULL, WS_ARCHETYPE };
+			writer.startBox("Storage benchmark");
+			writer.startTable(HEADERS, 6);
+			for (int i = 0; i < 2; ++i) {
+				StorageTimes times = run(storages[i], num, iterations);
+				writer.startRow();
+				writer.addCell(NAMES[i]);
+				writer.addCell(num);
+				writer.addCell(times.set);
+				writer.addCell(times.iterate);
+				writer.addCell(times.detach);
+				writer.addCell(times.checksum);
+				writer.endRow();
+			}
+			writer.endTable();
+			writer.endBox();
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+#include "..\io\ReportWriter.h"
+
+namespace ds {
+
+	namespace benchmark {
+
+		// -----------------------------------------------
+		// compare storage - runs the same custom channel
+		// workload on a WS_FULL and a WS_ARCHETYPE world
+		// and writes the time of every step in ms. Every
+		// second entity gets a second channel so the
+		// archetype world holds two archetypes.
+		// -----------------------------------------------
+		void compareStorage(const ReportWriter& writer, int num, int iterations = 16);
+
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "TextureTable.h"
+#include "..\memory\DefaultAllocator.h"
+#include "..\base\Assert.h"
+#include <string.h>
+
+namespace ds {
+
+	TextureTable::TextureTable() : _size(0), _last(0) {
+		for (int i = 0; i < MAX_TEXTURE_PAGES; ++i) {
+			_pages[i] = 0;
+		}
+	}
+
+	TextureTable::~TextureTable() {
+		for (int i = 0; i < MAX_TEXTURE_PAGES; ++i) {
+			if (_pages[i] != 0) {
+				DEALLOC(_pages[i]);
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// add - linear search starting with the last hit.
+	// New entries are appended to the last page.
+	// -----------------------------------------------
+	uint16_t TextureTable::add(const Texture& texture) {
+		if (_last < _size && memcmp(&get((uint16_t)_last), &texture, sizeof(Texture)) == 0) {
+			return (uint16_t)_last;
+		}
+		for (uint32_t i = 0; i < _size; ++i) {
+			if (memcmp(&get((uint16_t)i), &texture, sizeof(Texture)) == 0) {
+				_last = i;
+				return (uint16_t)i;
+			}
+		}
+		XASSERT(_size < TEXTURE_PAGE_SIZE * MAX_TEXTURE_PAGES, "The texture table is full");
+		int page = _size / TEXTURE_PAGE_SIZE;
+		if (_pages[page] == 0) {
+			_pages[page] = (Texture*)ALLOC(TEXTURE_PAGE_SIZE * sizeof(Texture));
+		}
+		_pages[page][_size % TEXTURE_PAGE_SIZE] = texture;
+		_last = _size++;
+		return (uint16_t)_last;
+	}
+
+}
\ No newline at end of file
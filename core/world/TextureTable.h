@@ -0,0 +1,41 @@
+#pragma once
+#include "..\Common.h"
+#include "..\graphics\Texture.h"
+
+namespace ds {
+
+	const int TEXTURE_PAGE_SIZE = 256;
+	const int MAX_TEXTURE_PAGES = 256;
+
+	// -----------------------------------------------
+	// TextureTable - the textures of a World using
+	// WS_COMPACT storage. The entries are stored in
+	// pages which are never moved or freed before the
+	// table is destroyed, so a reference returned by
+	// get stays valid and readers on other threads can
+	// look up every index they have read from a 
+	// snapshot. Only the simulation thread adds.
+	// -----------------------------------------------
+	class TextureTable {
+
+	public:
+		TextureTable();
+		~TextureTable();
+		// returns the index of the texture - equal textures share one entry
+		uint16_t add(const Texture& texture);
+		const Texture& get(uint16_t index) const {
+			return _pages[index / TEXTURE_PAGE_SIZE][index % TEXTURE_PAGE_SIZE];
+		}
+		uint32_t size() const {
+			return _size;
+		}
+	private:
+		TextureTable(const TextureTable& other);
+		TextureTable& operator=(const TextureTable& other);
+		Texture* _pages[MAX_TEXTURE_PAGES];
+		uint32_t _size;
+		// entities are mostly created in batches of the same texture
+		uint32_t _last;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,312 @@
+#include "Timeline.h"
+#include "..\base\Assert.h"
+#include "actions\AbstractAction.h"
+#include "..\profiler\Profiler.h"
+
+namespace ds {
+
+	// maximum number of ops a runner executes per tick
+	const int MAX_TIMELINE_STEPS = 64;
+
+	// -----------------------------------------------
+	// finishes - true if the action sends a completion
+	// event that a join can wait for
+	// -----------------------------------------------
+	static bool finishes(const ActionSettings* s) {
+		switch (s->type) {
+			case AT_SEEK:
+			case AT_SEPARATE:
+			case AT_REMOVE_AFTER:
+				return false;
+			case AT_MOVE_BY:
+			case AT_ROTATE:
+			case AT_LOOK_AT:
+			case AT_ALIGN_TO_FORCE:
+			case AT_WIGGLE:
+				return s->ttl > 0.0f;
+			default:
+				return true;
+		}
+	}
+
+	Timelines::Timelines(ActionManager* actionManager) : _actionManager(actionManager) {
+	}
+
+	Timelines::~Timelines() {
+		for (uint32_t i = 0; i < _timelines.size(); ++i) {
+			_timelines[i]->settings.destroy_all();
+		}
+		_timelines.destroy_all();
+	}
+
+	// -----------------------------------------------
+	// create timeline
+	// -----------------------------------------------
+	ID Timelines::create(const char* name) {
+		Timeline* t = new Timeline;
+		t->hash = SID(name);
+		t->numRepeats = 0;
+		t->mark = 0;
+		_timelines.push_back(t);
+		return _timelines.size() - 1;
+	}
+
+	// -----------------------------------------------
+	// add - start the action and wait until it is done
+	// -----------------------------------------------
+	void Timelines::add(ID timeline, ActionSettings* settings) {
+		addParallel(timeline, &settings, 1);
+	}
+
+	// -----------------------------------------------
+	// add parallel - start all actions and wait until
+	// every one of them that finishes is done
+	// -----------------------------------------------
+	void Timelines::addParallel(ID timeline, ActionSettings** settings, int num) {
+		Timeline* t = _timelines[timeline];
+		int waits = 0;
+		for (int i = 0; i < num; ++i) {
+			if (finishes(settings[i])) {
+				++waits;
+			}
+		}
+		XASSERT(waits <= MAX_TIMELINE_WAITS, "Too many parallel actions in one timeline step: %d", waits);
+		for (int i = 0; i < num; ++i) {
+			TimelineOp op;
+			op.code = TOP_START;
+			op.index = t->settings.size();
+			op.count = 0;
+			op.counter = 0;
+			op.duration = 0.0f;
+			t->settings.push_back(settings[i]);
+			t->ops.push_back(op);
+		}
+		TimelineOp join;
+		join.code = TOP_JOIN;
+		join.index = 0;
+		join.count = 0;
+		join.counter = 0;
+		join.duration = 0.0f;
+		t->ops.push_back(join);
+	}
+
+	// -----------------------------------------------
+	// wait
+	// -----------------------------------------------
+	void Timelines::wait(ID timeline, float ttl) {
+		if (ttl > 0.0f) {
+			TimelineOp op;
+			op.code = TOP_WAIT;
+			op.index = 0;
+			op.count = 0;
+			op.counter = 0;
+			op.duration = ttl;
+			_timelines[timeline]->ops.push_back(op);
+		}
+	}
+
+	// -----------------------------------------------
+	// repeat - everything since the start or the last
+	// repeat will be repeated. times < 0 means forever
+	// -----------------------------------------------
+	void Timelines::repeat(ID timeline, int times) {
+		Timeline* t = _timelines[timeline];
+		XASSERT(t->numRepeats < MAX_TIMELINE_REPEATS, "Too many repeats in one timeline");
+		TimelineOp op;
+		op.code = TOP_REPEAT;
+		op.index = t->mark;
+		op.count = times;
+		op.counter = t->numRepeats++;
+		op.duration = 0.0f;
+		t->ops.push_back(op);
+		t->mark = t->ops.size();
+	}
+
+	// -----------------------------------------------
+	// start timeline by hash
+	// -----------------------------------------------
+	void Timelines::start(const StaticHash& hash, ID id) {
+		int idx = -1;
+		for (uint32_t i = 0; i < _timelines.size(); ++i) {
+			if (_timelines[i]->hash == hash) {
+				idx = i;
+			}
+		}
+		XASSERT(idx != -1, "Cannot find matching timeline");
+		start(idx, id);
+	}
+
+	// -----------------------------------------------
+	// start timeline - replaces the current one
+	// -----------------------------------------------
+	void Timelines::start(int timeline, ID id) {
+		int idx = find(id);
+		if (idx == -1) {
+			while (_indices.size() <= id) {
+				_indices.push_back(-1);
+			}
+			TimelineRunner runner;
+			_runners.push_back(runner);
+			idx = _runners.size() - 1;
+			_indices[id] = idx;
+		}
+		TimelineRunner& r = _runners[idx];
+		r.id = id;
+		r.timeline = timeline;
+		r.pc = 0;
+		r.remaining = 0.0f;
+		r.numWaits = 0;
+		for (int i = 0; i < MAX_TIMELINE_REPEATS; ++i) {
+			r.counters[i] = 0;
+		}
+		// the first steps are executed right away
+		if (!step(r)) {
+			remove(idx);
+		}
+	}
+
+	// -----------------------------------------------
+	// stop - the running actions are not stopped
+	// -----------------------------------------------
+	void Timelines::stop(ID id) {
+		int idx = find(id);
+		if (idx != -1) {
+			remove(idx);
+		}
+	}
+
+	bool Timelines::isActive(ID id) const {
+		return find(id) != -1;
+	}
+
+	// -----------------------------------------------
+	// tick
+	// -----------------------------------------------
+	void Timelines::tick(float dt) {
+		ZoneTracker z("World::tick::timelines");
+		uint32_t i = 0;
+		while (i < _runners.size()) {
+			TimelineRunner& r = _runners[i];
+			// runners at a join are resumed by processEvent
+			if (r.numWaits != 0) {
+				++i;
+				continue;
+			}
+			r.remaining -= dt;
+			if (r.remaining <= 0.0f && !step(r)) {
+				remove(i);
+			}
+			else {
+				++i;
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// process event - an action started by the runner
+	// is done when its own attachment has been removed
+	// or replaced by another one. Events of an action
+	// that is still running (like a move by leaving 
+	// the screen) are ignored. The runner is resumed 
+	// when the last action the join waits for is done.
+	// -----------------------------------------------
+	void Timelines::processEvent(const ActionEvent& event) {
+		int idx = find(event.id);
+		if (idx == -1) {
+			return;
+		}
+		TimelineRunner& r = _runners[idx];
+		for (int i = 0; i < r.numWaits; ++i) {
+			TimelineWait& w = r.waits[i];
+			if (w.type == event.action) {
+				AbstractAction* action = _actionManager->get(w.type);
+				if (action->getAttachment(r.id) == w.attachment && action->contains(r.id)) {
+					return;
+				}
+				r.waits[i] = r.waits[--r.numWaits];
+				if (r.numWaits == 0 && !step(r)) {
+					remove(idx);
+				}
+				return;
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// step - executes ops until the next wait or join.
+	// Returns false if the timeline is finished
+	// -----------------------------------------------
+	bool Timelines::step(TimelineRunner& r) {
+		const Timeline* t = _timelines[r.timeline];
+		int num = t->ops.size();
+		int cnt = 0;
+		while (r.remaining <= 0.0f && r.pc < num && cnt < MAX_TIMELINE_STEPS) {
+			const TimelineOp& op = t->ops[r.pc];
+			++r.pc;
+			++cnt;
+			if (op.code == TOP_START) {
+				ActionSettings* s = t->settings[op.index];
+				AbstractAction* action = _actionManager->get(s->type);
+				action->attach(r.id, s);
+				if (finishes(s)) {
+					// a second action of the same type replaces the first one
+					int w = 0;
+					while (w < r.numWaits && r.waits[w].type != s->type) {
+						++w;
+					}
+					if (w == r.numWaits) {
+						++r.numWaits;
+					}
+					r.waits[w].type = s->type;
+					r.waits[w].attachment = action->getAttachment(r.id);
+				}
+			}
+			else if (op.code == TOP_JOIN) {
+				if (r.numWaits != 0) {
+					// stay on the join and drop the overshoot of the last wait
+					--r.pc;
+					r.remaining = 0.0f;
+					return true;
+				}
+			}
+			else if (op.code == TOP_WAIT) {
+				// keep the overshoot so the steps do not drift
+				r.remaining += op.duration;
+			}
+			else if (op.code == TOP_REPEAT) {
+				if (op.count < 0 || r.counters[op.counter] < op.count) {
+					++r.counters[op.counter];
+					r.pc = op.index;
+				}
+				else {
+					r.counters[op.counter] = 0;
+				}
+			}
+		}
+		return r.pc < num || r.remaining > 0.0f;
+	}
+
+	// -----------------------------------------------
+	// find runner of entity
+	// -----------------------------------------------
+	int Timelines::find(ID id) const {
+		if (id < _indices.size()) {
+			return _indices[id];
+		}
+		return -1;
+	}
+
+	// -----------------------------------------------
+	// remove runner - swaps in the last one
+	// -----------------------------------------------
+	void Timelines::remove(int index) {
+		uint32_t last = _runners.size() - 1;
+		_indices[_runners[index].id] = -1;
+		if ((uint32_t)index != last) {
+			_runners[index] = _runners[last];
+			_indices[_runners[index].id] = index;
+		}
+		_runners.pop_back();
+	}
+
+}
\ No newline at end of file
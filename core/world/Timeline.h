@@ -0,0 +1,109 @@
+#pragma once
+#include "ActionManager.h"
+#include "ActionEventBuffer.h"
+#include "..\lib\collection_types.h"
+#include "..\string\StaticHash.h"
+
+namespace ds {
+
+	struct ActionSettings;
+
+	enum TimelineOpCode {
+		TOP_START,
+		TOP_JOIN,
+		TOP_WAIT,
+		TOP_REPEAT
+	};
+
+	// -----------------------------------------------
+	// TOP_START  : index = settings
+	// TOP_JOIN   : waits until all started actions 
+	//              have sent their completion event
+	// TOP_WAIT   : duration
+	// TOP_REPEAT : index = target, count = number of 
+	//              repeats (< 0 = forever), counter = 
+	//              slot of the runner counter
+	// -----------------------------------------------
+	struct TimelineOp {
+		TimelineOpCode code;
+		int index;
+		int count;
+		int counter;
+		float duration;
+	};
+
+	const int MAX_TIMELINE_REPEATS = 4;
+	// maximum number of actions a join waits for
+	const int MAX_TIMELINE_WAITS = 8;
+
+	// -----------------------------------------------
+	// TimelineWait - an action started by the runner
+	// and the attachment it created
+	// -----------------------------------------------
+	struct TimelineWait {
+		ActionType type;
+		uint32_t attachment;
+	};
+
+	struct Timeline {
+		StaticHash hash;
+		Array<TimelineOp> ops;
+		Array<ActionSettings*> settings;
+		int numRepeats;
+		int mark;
+	};
+
+	struct TimelineRunner {
+		ID id;
+		int timeline;
+		int pc;
+		float remaining;
+		// the started actions that are not done
+		TimelineWait waits[MAX_TIMELINE_WAITS];
+		int numWaits;
+		int counters[MAX_TIMELINE_REPEATS];
+	};
+
+	// -----------------------------------------------
+	// Timelines
+	//
+	// A timeline is a list of actions that are started
+	// in sequence or in parallel along with waits and
+	// repeats. It is compiled into a small program and
+	// every entity running it only keeps a program 
+	// counter and the time left until the next step.
+	// A step waits for the completion events of the
+	// actions it has attached itself. An action that
+	// is replaced by another attach counts as done.
+	// Actions that never finish (like seek or a 
+	// move by without ttl) are started but not 
+	// waited for.
+	// -----------------------------------------------
+	class Timelines {
+
+	public:
+		Timelines(ActionManager* actionManager);
+		~Timelines();
+		ID create(const char* name);
+		void add(ID timeline, ActionSettings* settings);
+		void addParallel(ID timeline, ActionSettings** settings, int num);
+		void wait(ID timeline, float ttl);
+		void repeat(ID timeline, int times);
+		void start(const StaticHash& hash, ID id);
+		void start(int timeline, ID id);
+		void stop(ID id);
+		bool isActive(ID id) const;
+		void tick(float dt);
+		void processEvent(const ActionEvent& event);
+	private:
+		int find(ID id) const;
+		void remove(int index);
+		bool step(TimelineRunner& runner);
+		ActionManager* _actionManager;
+		Array<Timeline*> _timelines;
+		Array<TimelineRunner> _runners;
+		// entity ID -> index in _runners
+		Array<int> _indices;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "TimerWheel.h"
+#include <math.h>
+
+namespace ds {
+
+	const int TW_INDEX_BITS = 20;
+	const uint32_t TW_INDEX_MASK = (1 << TW_INDEX_BITS) - 1;
+	const uint32_t TW_GENERATION_MASK = 0xfff;
+
+	static TimerHandle make_handle(int index, uint16_t generation) {
+		return ((generation & TW_GENERATION_MASK) << TW_INDEX_BITS) | (uint32_t)index;
+	}
+
+	TimerWheel::TimerWheel(float resolution) : _resolution(resolution), _accumulator(0.0f), _current(0), _free(-1), _active(0) {
+		for (int i = 0; i < TW_NUM_SLOTS; ++i) {
+			_heads[i] = -1;
+		}
+	}
+
+	// -----------------------------------------------
+	// schedule - the timer fires during the first 
+	// advance where the accumulated time reaches delay
+	// -----------------------------------------------
+	TimerHandle TimerWheel::schedule(float delay, ID id, int owner, int type, int data) {
+		int index = _free;
+		if (index != -1) {
+			_free = _nodes[index].next;
+		}
+		else {
+			assert(_nodes.size() < TW_INDEX_MASK);
+			TimerNode node;
+			node.generation = 0;
+			_nodes.push_back(node);
+			index = _nodes.size() - 1;
+		}
+		TimerNode& n = _nodes[index];
+		uint64_t ticks = 0;
+		float total = delay + _accumulator;
+		if (total > _resolution) {
+			ticks = (uint64_t)ceil(total / _resolution) - 1;
+		}
+		n.expires = _current + ticks;
+		n.id = id;
+		n.owner = owner;
+		n.type = type;
+		n.data = data;
+		insert(index);
+		++_active;
+		return make_handle(index, n.generation);
+	}
+
+	// -----------------------------------------------
+	// cancel - handles of timers that have already
+	// fired or been cancelled are ignored
+	// -----------------------------------------------
+	void TimerWheel::cancel(TimerHandle handle) {
+		int index = find(handle);
+		if (index != -1) {
+			unlink(index);
+			release(index);
+		}
+	}
+
+	bool TimerWheel::isActive(TimerHandle handle) const {
+		return find(handle) != -1;
+	}
+
+	// -----------------------------------------------
+	// set data - owners use it to keep track of rows
+	// that have been moved around
+	// -----------------------------------------------
+	void TimerWheel::setData(TimerHandle handle, int data) {
+		int index = find(handle);
+		if (index != -1) {
+			_nodes[index].data = data;
+		}
+	}
+
+	float TimerWheel::remaining(TimerHandle handle) const {
+		int index = find(handle);
+		if (index != -1) {
+			const TimerNode& n = _nodes[index];
+			return (float)(n.expires - _current + 1) * _resolution - _accumulator;
+		}
+		return 0.0f;
+	}
+
+	// -----------------------------------------------
+	// advance - appends all expired timers
+	// -----------------------------------------------
+	void TimerWheel::advance(float dt, Array<TimerEvent>& expired) {
+		_accumulator += dt;
+		while (_accumulator >= _resolution) {
+			_accumulator -= _resolution;
+			if (_active > 0) {
+				step(expired);
+			}
+			else {
+				++_current;
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// clear - cancels all timers
+	// -----------------------------------------------
+	void TimerWheel::clear() {
+		for (uint32_t i = 0; i < _nodes.size(); ++i) {
+			if (_nodes[i].slot != -1) {
+				release(i);
+			}
+		}
+		for (int i = 0; i < TW_NUM_SLOTS; ++i) {
+			_heads[i] = -1;
+		}
+	}
+
+	// -----------------------------------------------
+	// step - process one tick
+	// -----------------------------------------------
+	void TimerWheel::step(Array<TimerEvent>& expired) {
+		int index = (int)(_current & TW_ROOT_MASK);
+		if (index == 0) {
+			for (int l = 0; l < TW_NUM_LEVELS; ++l) {
+				int slot = (int)((_current >> (TW_ROOT_BITS + l * TW_LEVEL_BITS)) & TW_LEVEL_MASK);
+				cascade(l, slot);
+				if (slot != 0) {
+					break;
+				}
+			}
+		}
+		int current = _heads[index];
+		_heads[index] = -1;
+		while (current != -1) {
+			const TimerNode& n = _nodes[current];
+			int next = n.next;
+			TimerEvent e;
+			e.handle = make_handle(current, n.generation);
+			e.id = n.id;
+			e.owner = n.owner;
+			e.type = n.type;
+			e.data = n.data;
+			expired.push_back(e);
+			release(current);
+			current = next;
+		}
+		++_current;
+	}
+
+	// -----------------------------------------------
+	// insert node into the matching slot
+	// -----------------------------------------------
+	void TimerWheel::insert(int index) {
+		TimerNode& n = _nodes[index];
+		uint64_t delta = n.expires - _current;
+		int slot = 0;
+		if (delta < TW_ROOT_SIZE) {
+			slot = (int)(n.expires & TW_ROOT_MASK);
+		}
+		else {
+			for (int l = 0; l < TW_NUM_LEVELS; ++l) {
+				uint64_t range = 1ULL << (TW_ROOT_BITS + (l + 1) * TW_LEVEL_BITS);
+				if (delta < range || l == TW_NUM_LEVELS - 1) {
+					uint64_t expires = n.expires;
+					if (delta >= range) {
+						// too far away - park it in the last slot and let cascade handle it
+						expires = _current + range - 1;
+					}
+					slot = TW_ROOT_SIZE + l * TW_LEVEL_SIZE + (int)((expires >> (TW_ROOT_BITS + l * TW_LEVEL_BITS)) & TW_LEVEL_MASK);
+					break;
+				}
+			}
+		}
+		n.slot = slot;
+		n.prev = -1;
+		n.next = _heads[slot];
+		if (n.next != -1) {
+			_nodes[n.next].prev = index;
+		}
+		_heads[slot] = index;
+	}
+
+	// -----------------------------------------------
+	// unlink node from its slot
+	// -----------------------------------------------
+	void TimerWheel::unlink(int index) {
+		TimerNode& n = _nodes[index];
+		if (n.prev != -1) {
+			_nodes[n.prev].next = n.next;
+		}
+		else {
+			_heads[n.slot] = n.next;
+		}
+		if (n.next != -1) {
+			_nodes[n.next].prev = n.prev;
+		}
+	}
+
+	// -----------------------------------------------
+	// release node back into the free list
+	// -----------------------------------------------
+	void TimerWheel::release(int index) {
+		TimerNode& n = _nodes[index];
+		n.slot = -1;
+		++n.generation;
+		n.next = _free;
+		_free = index;
+		--_active;
+	}
+
+	// -----------------------------------------------
+	// cascade - move all timers of a slot one level down
+	// -----------------------------------------------
+	void TimerWheel::cascade(int level, int slot) {
+		int idx = TW_ROOT_SIZE + level * TW_LEVEL_SIZE + slot;
+		int current = _heads[idx];
+		_heads[idx] = -1;
+		while (current != -1) {
+			int next = _nodes[current].next;
+			insert(current);
+			current = next;
+		}
+	}
+
+	// -----------------------------------------------
+	// find node index by handle
+	// -----------------------------------------------
+	int TimerWheel::find(TimerHandle handle) const {
+		if (handle == INVALID_TIMER) {
+			return -1;
+		}
+		uint32_t index = handle & TW_INDEX_MASK;
+		if (index >= _nodes.size()) {
+			return -1;
+		}
+		const TimerNode& n = _nodes[index];
+		if (n.slot == -1 || (n.generation & TW_GENERATION_MASK) != (handle >> TW_INDEX_BITS)) {
+			return -1;
+		}
+		return index;
+	}
+
+}
\ No newline at end of file
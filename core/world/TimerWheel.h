@@ -0,0 +1,90 @@
+#pragma once
+#include "..\Common.h"
+#include "..\lib\collection_types.h"
+
+namespace ds {
+
+	typedef uint32_t TimerHandle;
+
+	const TimerHandle INVALID_TIMER = UINT32_MAX;
+
+	// -----------------------------------------------
+	// who scheduled the timer and has to handle it
+	// -----------------------------------------------
+	enum TimerOwner {
+		TO_ACTION,
+		TO_CUSTOM_ACTION,
+		TO_BEHAVIOR,
+		TO_SCRIPT
+	};
+
+	struct TimerEvent {
+		TimerHandle handle;
+		ID id;
+		int owner;
+		int type;
+		int data;
+	};
+
+	// -----------------------------------------------
+	// Hierarchical timer wheel
+	//
+	// The first level has 256 slots with one slot per
+	// tick. The other three levels have 64 slots each
+	// and get cascaded down whenever the level below
+	// wraps around. Scheduling and cancelling is O(1)
+	// and advancing is O(ticks + expired timers).
+	// -----------------------------------------------
+	const int TW_ROOT_BITS = 8;
+	const int TW_LEVEL_BITS = 6;
+	const int TW_ROOT_SIZE = 1 << TW_ROOT_BITS;
+	const int TW_LEVEL_SIZE = 1 << TW_LEVEL_BITS;
+	const int TW_ROOT_MASK = TW_ROOT_SIZE - 1;
+	const int TW_LEVEL_MASK = TW_LEVEL_SIZE - 1;
+	const int TW_NUM_LEVELS = 3;
+	const int TW_NUM_SLOTS = TW_ROOT_SIZE + TW_NUM_LEVELS * TW_LEVEL_SIZE;
+
+	class TimerWheel {
+
+		struct TimerNode {
+			uint64_t expires;
+			ID id;
+			int owner;
+			int type;
+			int data;
+			int slot;
+			int prev;
+			int next;
+			uint16_t generation;
+		};
+
+	public:
+		TimerWheel(float resolution = 0.001f);
+		~TimerWheel() {}
+		TimerHandle schedule(float delay, ID id, int owner, int type, int data = 0);
+		void cancel(TimerHandle handle);
+		bool isActive(TimerHandle handle) const;
+		void setData(TimerHandle handle, int data);
+		float remaining(TimerHandle handle) const;
+		void advance(float dt, Array<TimerEvent>& expired);
+		void clear();
+		uint32_t size() const {
+			return _active;
+		}
+	private:
+		void step(Array<TimerEvent>& expired);
+		void insert(int index);
+		void unlink(int index);
+		void release(int index);
+		void cascade(int level, int slot);
+		int find(TimerHandle handle) const;
+		float _resolution;
+		float _accumulator;
+		uint64_t _current;
+		int _heads[TW_NUM_SLOTS];
+		Array<TimerNode> _nodes;
+		int _free;
+		uint32_t _active;
+	};
+
+}
\ No newline at end of file
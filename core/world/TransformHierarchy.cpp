@@ -0,0 +1,287 @@
+#include "TransformHierarchy.h"
+#include "World.h"
+#include "EntityChannels.h"
+#include "..\profiler\Profiler.h"
+#include "..\base\Assert.h"
+#include <math.h>
+
+namespace ds {
+
+	// -----------------------------------------------
+	// transform - scales first and then rotates
+	// counter clock wise like the sprites are drawn
+	// -----------------------------------------------
+	static mat3 transform(const v2& p, float rotation, const v2& s) {
+		float ca = cosf(rotation);
+		float sa = sinf(rotation);
+		return mat3(
+			ca * s.x, -sa * s.y, p.x,
+			sa * s.x,  ca * s.y, p.y,
+			0.0f, 0.0f, 1.0f
+		);
+	}
+
+	TransformHierarchy::TransformHierarchy(ChannelArray* data) : _data(data) , _sorted(true) {
+	}
+
+	// -----------------------------------------------
+	// attach - the child moves with the parent. The
+	// current scale of the child is the local scale.
+	// -----------------------------------------------
+	void TransformHierarchy::attach(ID child, ID parent, const v2& position, float rotation) {
+		XASSERT(child != parent, "Cannot attach %d to itself", child);
+		int p = find(parent);
+		while (p != -1) {
+			XASSERT(_nodes[p].parent != child, "Attaching %d to %d would create a cycle", child, parent);
+			p = find(_nodes[p].parent);
+		}
+		int idx = find(child);
+		if (idx == -1) {
+			TransformNode node;
+			_nodes.push_back(node);
+			_world.push_back(matrix::identity());
+			idx = _nodes.size() - 1;
+			setIndex(child, idx);
+		}
+		TransformNode& node = _nodes[idx];
+		v3 s = channels::getScale(_data, child);
+		node.id = child;
+		node.parent = parent;
+		node.parentIndex = -1;
+		node.depth = 0;
+		node.position = position;
+		node.rotation = rotation;
+		node.scale = v2(s.x, s.y);
+		node.parentPosition = v3(0.0f);
+		node.parentRotation = 0.0f;
+		node.parentScale = v3(0.0f);
+		node.dirty = true;
+		node.changed = false;
+		_sorted = false;
+	}
+
+	// -----------------------------------------------
+	// detach - the child keeps its last transform and
+	// children attached to it stay attached. The last
+	// node is moved into the gap.
+	// -----------------------------------------------
+	void TransformHierarchy::detach(ID child) {
+		int idx = find(child);
+		if (idx != -1) {
+			setIndex(child, -1);
+			uint32_t last = _nodes.size() - 1;
+			if ((uint32_t)idx != last) {
+				_nodes[idx] = _nodes[last];
+				_world[idx] = _world[last];
+				setIndex(_nodes[idx].id, idx);
+			}
+			_nodes.pop_back();
+			_world.pop_back();
+			_sorted = false;
+		}
+	}
+
+	// -----------------------------------------------
+	// remove - an entity is removed from the world
+	// -----------------------------------------------
+	void TransformHierarchy::remove(ID id) {
+		detach(id);
+	}
+
+	bool TransformHierarchy::contains(ID child) const {
+		return find(child) != -1;
+	}
+
+	void TransformHierarchy::setLocalPosition(ID child, const v2& position) {
+		int idx = find(child);
+		if (idx != -1) {
+			_nodes[idx].position = position;
+			_nodes[idx].dirty = true;
+		}
+	}
+
+	void TransformHierarchy::setLocalRotation(ID child, float rotation) {
+		int idx = find(child);
+		if (idx != -1) {
+			_nodes[idx].rotation = rotation;
+			_nodes[idx].dirty = true;
+		}
+	}
+
+	// -----------------------------------------------
+	// get children - direct children of the parent
+	// -----------------------------------------------
+	int TransformHierarchy::getChildren(ID parent, ID* ids, int max) const {
+		int cnt = 0;
+		for (uint32_t i = 0; i < _nodes.size() && cnt < max; ++i) {
+			if (_nodes[i].parent == parent) {
+				ids[cnt++] = _nodes[i].id;
+			}
+		}
+		return cnt;
+	}
+
+	void TransformHierarchy::markActive(uint32_t* bits) const {
+		for (uint32_t i = 0; i < _nodes.size(); ++i) {
+			if (_nodes[i].changed) {
+				uint32_t index = _nodes[i].id & INDEX_MASK;
+				bits[index >> 5] |= 1u << (index & 31);
+			}
+		}
+	}
+
+	int TransformHierarchy::find(ID child) const {
+		uint32_t index = child & INDEX_MASK;
+		if (index < _indices.size()) {
+			int idx = _indices[index];
+			if (idx != -1 && _nodes[idx].id == child) {
+				return idx;
+			}
+		}
+		return -1;
+	}
+
+	void TransformHierarchy::setIndex(ID id, int index) {
+		uint32_t i = id & INDEX_MASK;
+		while (_indices.size() <= i) {
+			_indices.push_back(-1);
+		}
+		_indices[i] = index;
+	}
+
+	// -----------------------------------------------
+	// depth - walks up until a node with a known depth
+	// or a root and assigns the depths on the way back
+	// so every node is visited once per sort
+	// -----------------------------------------------
+	int TransformHierarchy::depth(int index) {
+		_chain.clear();
+		int current = index;
+		int d = -1;
+		while (current != -1) {
+			if (_nodes[current].depth != -1) {
+				d = _nodes[current].depth;
+				break;
+			}
+			_chain.push_back(current);
+			current = find(_nodes[current].parent);
+		}
+		for (int i = _chain.size() - 1; i >= 0; --i) {
+			_nodes[_chain[i]].depth = ++d;
+		}
+		return _nodes[index].depth;
+	}
+
+	// -----------------------------------------------
+	// sort - counting sort by depth so that parents
+	// precede their children. Only called after the
+	// hierarchy has changed.
+	// -----------------------------------------------
+	void TransformHierarchy::sort() {
+		uint32_t num = _nodes.size();
+		for (uint32_t i = 0; i < num; ++i) {
+			_nodes[i].depth = -1;
+		}
+		int maxDepth = 0;
+		for (uint32_t i = 0; i < num; ++i) {
+			int d = depth(i);
+			if (d > maxDepth) {
+				maxDepth = d;
+			}
+		}
+		_counts.clear();
+		for (int d = 0; d <= maxDepth + 1; ++d) {
+			_counts.push_back(0);
+		}
+		for (uint32_t i = 0; i < num; ++i) {
+			++_counts[_nodes[i].depth + 1];
+		}
+		for (int d = 1; d <= maxDepth + 1; ++d) {
+			_counts[d] += _counts[d - 1];
+		}
+		_scratch.clear();
+		for (uint32_t i = 0; i < num; ++i) {
+			_scratch.push_back(_nodes[i]);
+		}
+		for (uint32_t i = 0; i < num; ++i) {
+			const TransformNode& node = _scratch[i];
+			int idx = _counts[node.depth]++;
+			_nodes[idx] = node;
+			setIndex(node.id, idx);
+		}
+		for (uint32_t i = 0; i < num; ++i) {
+			TransformNode& node = _nodes[i];
+			node.parentIndex = find(node.parent);
+			node.dirty = true;
+		}
+		_sorted = true;
+	}
+
+	// -----------------------------------------------
+	// update - one pass over all nodes. A node is 
+	// recomputed when its local transform or the 
+	// world transform of its parent has changed.
+	// -----------------------------------------------
+	void TransformHierarchy::update(DirtyChannels* dirty) {
+		ZoneTracker z("TransformHierarchy::update");
+		if (!_sorted) {
+			sort();
+		}
+		v3* positions = (v3*)_data->get_ptr(WEC_POSITION);
+		for (uint32_t i = 0; i < _nodes.size(); ++i) {
+			TransformNode& node = _nodes[i];
+			if (!_data->contains(node.id)) {
+				node.changed = false;
+				continue;
+			}
+			bool changed = node.dirty;
+			const mat3* parentWorld = 0;
+			mat3 root;
+			if (node.parentIndex == -1) {
+				if (!_data->contains(node.parent)) {
+					node.changed = false;
+					continue;
+				}
+				int pi = _data->_sparse[node.parent & INDEX_MASK];
+				const v3& pp = positions[pi];
+				float pr = channels::rotationAt(_data, pi);
+				v3 ps = channels::scaleAt(_data, pi);
+				if (pp.x != node.parentPosition.x || pp.y != node.parentPosition.y || pr != node.parentRotation || ps.x != node.parentScale.x || ps.y != node.parentScale.y) {
+					node.parentPosition = pp;
+					node.parentRotation = pr;
+					node.parentScale = ps;
+					changed = true;
+				}
+				if (changed) {
+					root = transform(v2(pp.x, pp.y), pr, v2(ps.x, ps.y));
+					parentWorld = &root;
+				}
+			}
+			else {
+				changed |= _nodes[node.parentIndex].changed;
+				parentWorld = &_world[node.parentIndex];
+			}
+			node.dirty = false;
+			node.changed = changed;
+			if (changed) {
+				mat3& m = _world[i];
+				m = *parentWorld * transform(node.position, node.rotation, node.scale);
+				int ci = _data->_sparse[node.id & INDEX_MASK];
+				positions[ci].x = m._13;
+				positions[ci].y = m._23;
+				v3 r = channels::getRotation(_data, node.id);
+				r.x = atan2f(m._21, m._11);
+				channels::setRotation(_data, node.id, r);
+				v3 s = channels::getScale(_data, node.id);
+				s.x = sqrtf(m._11 * m._11 + m._21 * m._21);
+				s.y = sqrtf(m._12 * m._12 + m._22 * m._22);
+				channels::setScale(_data, node.id, s);
+				if (dirty != 0) {
+					dirty->mark(node.id, WEC_MASK(WEC_POSITION) | WEC_MASK(WEC_ROTATION) | WEC_MASK(WEC_SCALE));
+				}
+				_data->wake(node.id);
+			}
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+#include "..\lib\BlockArray.h"
+#include "..\lib\collection_types.h"
+#include "..\math\matrix.h"
+#include "DirtyChannels.h"
+
+namespace ds {
+
+	// -----------------------------------------------
+	// TransformHierarchy - parent/child relations of
+	// entities (AT_MOVE_WITH). The nodes are kept
+	// sorted by depth so that every parent precedes
+	// its children and the world transforms can be
+	// propagated in one linear pass. Position, 
+	// rotation and scale of a child are owned by the
+	// hierarchy. Only children of changed parents or
+	// with changed local transforms are recomputed.
+	// Lazy tweens of a parent are picked up after
+	// they have been materialized.
+	// -----------------------------------------------
+	class TransformHierarchy {
+
+		struct TransformNode {
+			ID id;
+			ID parent;
+			int parentIndex;
+			int depth;
+			v2 position;
+			float rotation;
+			v2 scale;
+			// last transform of a root parent
+			v3 parentPosition;
+			float parentRotation;
+			v3 parentScale;
+			bool dirty;
+			bool changed;
+		};
+
+	public:
+		TransformHierarchy(ChannelArray* data);
+		~TransformHierarchy() {}
+		void attach(ID child, ID parent, const v2& position, float rotation);
+		void detach(ID child);
+		void remove(ID id);
+		bool contains(ID child) const;
+		void setLocalPosition(ID child, const v2& position);
+		void setLocalRotation(ID child, float rotation);
+		int getChildren(ID parent, ID* ids, int max) const;
+		void update(DirtyChannels* dirty = 0);
+		// sets the bit of every entity moved by the last update
+		void markActive(uint32_t* bits) const;
+		uint32_t size() const {
+			return _nodes.size();
+		}
+	private:
+		int find(ID child) const;
+		void setIndex(ID id, int index);
+		int depth(int index);
+		void sort();
+		ChannelArray* _data;
+		Array<TransformNode> _nodes;
+		Array<mat3> _world;
+		// entity index -> node index or -1
+		Array<int> _indices;
+		// scratch buffers of sort
+		Array<TransformNode> _scratch;
+		Array<int> _counts;
+		Array<int> _chain;
+		bool _sorted;
+	};
+
+}
\ No newline at end of file
@@ -18,20 +18,51 @@
 #include "actions\ColorFlashAction.h"
 #include "actions\WiggleAction.h"
 #include "actions\AlignToForceAction.h"
+#include "actions\FollowPathAction.h"
+#include "..\math\StraightPath.h"
+#include "..\jobs\FrameGraph.h"
+#include "SpriteExtraction.h"
+#include "ForceIntegration.h"
+#include "EntityChannels.h"
 
 namespace ds {
 
-	World::World() : _boundingRect(0,0,1024,768) {
+	World::World(WorldStorage storage) : _boundingRect(0,0,1024,768) {
 		_data = new ChannelArray;
-		int sizes[] = { sizeof(v3), sizeof(v3), sizeof(v3) ,sizeof(Texture) , sizeof(Color), sizeof(float), sizeof(int), sizeof(v3),sizeof(int),sizeof(StaticHash)};
-		_data->init(sizes, 10);
+		channels::init(_data, storage, &_textures);
 		_templates = 0;
-		_actionManager = new ActionManager(_data,_boundingRect);
-		_behaviors = new Behaviors(_actionManager);
+		_actionManager = new ActionManager(_data,_boundingRect,&_timers);
+		_behaviors = new Behaviors(_actionManager,&_timers);
+		_timelines = new Timelines(_actionManager);
+		_scripts = new Scripts(this, &_timers);
+		_snapshots = 0;
+		_hierarchy = new TransformHierarchy(_data);
+		_presence = -1;
+		_components = 0;
+		if (storage == WS_ARCHETYPE) {
+			_components = new ArchetypeStorage;
+		}
+		_actionManager->setDirtyChannels(&_dirty);
+		_sleeping = false;
+		_tweensPending = false;
+		_moved = 0;
+		_movedCapacity = 0;
 	}
 
 
 	World::~World()	{
+		if (_moved != 0) {
+			DEALLOC(_moved);
+		}
+		if (_snapshots != 0) {
+			delete _snapshots;
+		}
+		if (_components != 0) {
+			delete _components;
+		}
+		delete _hierarchy;
+		delete _scripts;
+		delete _timelines;
 		delete _behaviors;
 		delete _actionManager;		
 		delete _data;
@@ -56,7 +87,9 @@ namespace ds {
 	// create
 	// -----------------------------------------------
 	ID World::create() {
-		return _data->add();
+		ID id = _data->add();
+		_dirty.mark(id, ALL_CHANNELS);
+		return id;
 	}
 
 	// -----------------------------------------------
@@ -73,14 +106,15 @@ namespace ds {
 		ID id = _data->add();
 		//LOGC("world") << "create - id: " << id;
 		_data->set<v3>(id, WEC_POSITION, v3(pos));
-		_data->set<Texture>(id, WEC_TEXTURE, texture);
-		_data->set<v3>(id, WEC_ROTATION, v3(rotation,0.0f,0.0f));
-		_data->set<v3>(id, WEC_SCALE, v3(scale.x, scale.y, 1.0f));
-		_data->set<Color>(id, WEC_COLOR, color);
-		_data->set<int>(id, WEC_TYPE, type);
+		channels::setTexture(_data, id, texture);
+		channels::setRotation(_data, id, v3(rotation,0.0f,0.0f));
+		channels::setScale(_data, id, v3(scale.x, scale.y, 1.0f));
+		channels::setColor(_data, id, color);
+		channels::setType(_data, id, type);
 		_data->set<v3>(id, WEC_FORCE, v3(0.0f));
 		_data->set<int>(id, WEC_NAME, -1);
 		_data->set<StaticHash>(id, WEC_HASH, SID("-"));
+		_dirty.mark(id, ALL_CHANNELS);
 		return id;
 	}
 
@@ -97,47 +131,76 @@ namespace ds {
 	}
 
 	void World::setRotation(ID id, const v3& rotation) {
-		_data->set<v3>(id, WEC_ROTATION, rotation);
+		channels::setRotation(_data, id, rotation);
+		_dirty.mark(id, WEC_MASK(WEC_ROTATION));
+		_data->wake(id);
 	}
 
 	void World::setRotation(ID id, float rotation) {
-		_data->set<v3>(id, WEC_ROTATION, v3(rotation));
+		channels::setRotation(_data, id, v3(rotation));
+		_dirty.mark(id, WEC_MASK(WEC_ROTATION));
+		_data->wake(id);
 	}
 
 	void World::setColor(ID id, const Color& color) {
-		_data->set<Color>(id, WEC_COLOR, color);
+		channels::setColor(_data, id, color);
+		_dirty.mark(id, WEC_MASK(WEC_COLOR));
+		_data->wake(id);
 	}
 
 	void World::setPosition(ID id, const v2& pos) {
 		_data->set<v3>(id, WEC_POSITION, v3(pos));
+		_dirty.mark(id, WEC_MASK(WEC_POSITION));
+		_data->wake(id);
 	}
 
 	void World::setPosition(ID id, const v3& pos) {
 		_data->set<v3>(id, WEC_POSITION, pos);
+		_dirty.mark(id, WEC_MASK(WEC_POSITION));
+		_data->wake(id);
 	}
 
 	const v3& World::getPosition(ID id) const {
+		syncTweens();
 		return _data->get<v3>(id, WEC_POSITION);
 	}
 
 	int World::getType(ID id) const {
-		return _data->get<int>(id, WEC_TYPE);
+		return channels::getType(_data, id);
 	}
 
-	const v3& World::getRotation(ID id) const {
+	v3 World::getRotation(ID id) const {
+		syncTweens();
+		return channels::getRotation(_data, id);
+	}
+
+	v3 World::getScale(ID id) const {
+		syncTweens();
+		return channels::getScale(_data, id);
+	}
+
+	const v3& World::getRotationRef(ID id) const {
+		XASSERT(!channels::isCompact(_data), "The rotation of compact storage cannot be referenced");
+		syncTweens();
 		return _data->get<v3>(id, WEC_ROTATION);
 	}
 
-	const v3& World::getScale(ID id) const {
+	const v3& World::getScaleRef(ID id) const {
+		XASSERT(!channels::isCompact(_data), "The scale of compact storage cannot be referenced");
+		syncTweens();
 		return _data->get<v3>(id, WEC_SCALE);
 	}
 
 	void World::setTexture(ID id, const Texture& texture) {
-		_data->set<Texture>(id, WEC_TEXTURE, texture);
+		channels::setTexture(_data, id, texture);
+		_dirty.mark(id, WEC_MASK(WEC_TEXTURE));
+		_data->wake(id);
 	}
 
 	void World::setScale(ID id, const v3& s) {
-		_data->set<v3>(id, WEC_SCALE, s);
+		channels::setScale(_data, id, s);
+		_dirty.mark(id, WEC_MASK(WEC_SCALE));
+		_data->wake(id);
 	}
 	// -----------------------------------------------
 	// scale by path
@@ -147,6 +210,24 @@ namespace ds {
 		action->attach(id, path, ttl);
 	}
 
+	// -----------------------------------------------
+	// follow path
+	// -----------------------------------------------
+	void World::followPath(ID id, Path* path, float ttl, int mode, bool rotate) {
+		FollowPathAction* action = (FollowPathAction*)_actionManager->get(AT_FOLLOW_PATH);
+		action->attach(id, path, ttl, mode, rotate);
+	}
+
+	void World::followCurve(ID id, CubicBezierPath* path, float ttl, int mode, bool rotate) {
+		FollowPathAction* action = (FollowPathAction*)_actionManager->get(AT_FOLLOW_CURVE);
+		action->attach(id, path, ttl, mode, rotate);
+	}
+
+	void World::followStraightPath(ID id, StraightPath* path, float ttl, int mode, bool rotate) {
+		FollowPathAction* action = (FollowPathAction*)_actionManager->get(AT_FOLLOW_STRAIGHT_PATH);
+		action->attach(id, path, ttl, mode, rotate);
+	}
+
 	void World::scaleAxes(ID id, int axes, float start, float end, float ttl, int mode, const tweening::TweeningType& tweeningType) {
 		ScaleAxesAction* action = (ScaleAxesAction*)_actionManager->get(AT_SCALE_AXES);
 		action->attach(id, axes, start, end, ttl, mode, tweeningType);
@@ -166,6 +247,10 @@ namespace ds {
 		//LOGC("world") << "removing: " << id;
 		if (_data->contains(id)) {
 			_data->remove(id);
+			_dirty.remove(id);
+		}
+		if (_components != 0 && _components->contains(id)) {
+			_components->remove(id);
 		}
 		else {
 			LOGE << "requesting to remove " << id << " but it is not part of the world";
@@ -178,7 +263,20 @@ namespace ds {
 			CollisionAction* collisionAction = _actionManager->getCollisionAction();
 			collisionAction->removeByID(id);
 		}
+		_behaviors->removeByID(id);
+		_timelines->stop(id);
+		_scripts->removeByID(id);
 		_additionalData.remove(id);			
+		// children are moving with the entity so they are removed as well
+		_hierarchy->remove(id);
+		ID children[16];
+		int num = _hierarchy->getChildren(id, children, 16);
+		while (num > 0) {
+			for (int i = 0; i < num; ++i) {
+				remove(children[i]);
+			}
+			num = _hierarchy->getChildren(id, children, 16);
+		}
 	}
 
 	// -----------------------------------------------
@@ -216,7 +314,7 @@ namespace ds {
 		int cnt = 0;
 		for (int i = 0; i < _data->capacity; ++i) {
 			if (indices[i] != -1 && cnt < max) {
-				int t = _data->get<int>(i, WEC_TYPE);
+				int t = channels::getType(_data, i);
 				if (t == type) {
 					ids[cnt++] = i;
 				}
@@ -241,7 +339,7 @@ namespace ds {
 	// -----------------------------------------------
 	void World::attachCollider(ID id, ShapeType type) {
 		CollisionAction* collisionAction = _actionManager->getCollisionAction();
-		const Texture& t = _data->get<Texture>(id, WEC_TEXTURE);
+		const Texture& t = channels::getTexture(_data, id);
 		v3 extent = v3(t.dim.x, t.dim.y,0.0f);
 		collisionAction->attach(id, type, extent);
 	}
@@ -321,6 +419,79 @@ namespace ds {
 		AlphaFadeToAction* action = (AlphaFadeToAction*)_actionManager->get(AT_ALPHA_FADE_TO);
 		action->attach(id, start, end, ttl);
 	}
+
+	// -----------------------------------------------
+	// add custom channel - the first one also adds the
+	// presence channel which holds one bit per custom
+	// channel for every entity. WS_ARCHETYPE adds a 
+	// component to the storage instead.
+	// -----------------------------------------------
+	int World::addCustomChannel(const char* name, const void* type, int size) {
+		for (uint32_t i = 0; i < _customChannels.size(); ++i) {
+			XASSERT(_customChannels[i].type != type, "Channel %s uses an already registered type", name);
+		}
+		CustomChannel c;
+		c.name = SID(name);
+		c.type = type;
+		c.bit = 1 << _customChannels.size();
+		if (_components != 0) {
+			// the dirty channels follow the channels of the array
+			c.component = _components->addChannel(size);
+			c.channel = _data->_num_blocks + c.component;
+			XASSERT(c.channel < 32, "Too many custom channels");
+		}
+		else {
+			if (_presence == -1) {
+				_presence = _data->addChannel(sizeof(uint32_t));
+			}
+			c.channel = _data->addChannel(size);
+			c.component = -1;
+		}
+		_customChannels.push_back(c);
+		return c.channel;
+	}
+
+	const World::CustomChannel& World::getCustomChannel(const void* type) const {
+		for (uint32_t i = 0; i < _customChannels.size(); ++i) {
+			if (_customChannels[i].type == type) {
+				return _customChannels[i];
+			}
+		}
+		XASSERT(false, "The channel type is not registered");
+		return _customChannels[0];
+	}
+
+	// -----------------------------------------------
+	// find channel - returns the channel index of a
+	// custom channel or -1
+	// -----------------------------------------------
+	int World::findChannel(const char* name) const {
+		StaticHash hash = SID(name);
+		for (uint32_t i = 0; i < _customChannels.size(); ++i) {
+			if (_customChannels[i].name == hash) {
+				return _customChannels[i].channel;
+			}
+		}
+		return -1;
+	}
+
+	// -----------------------------------------------
+	// move with - the entity follows the parent at the
+	// given offset and rotation relative to it until
+	// stopAction(id, AT_MOVE_WITH) is called
+	// -----------------------------------------------
+	void World::moveWith(ID id, ID parent, const v2& offset, float rotation) {
+		XASSERT(_data->contains(parent), "Invalid parent %d", parent);
+		_hierarchy->attach(id, parent, offset, rotation);
+	}
+
+	void World::setLocalPosition(ID id, const v2& offset) {
+		_hierarchy->setLocalPosition(id, offset);
+	}
+
+	void World::setLocalRotation(ID id, float rotation) {
+		_hierarchy->setLocalRotation(id, rotation);
+	}
 	// -----------------------------------------------
 	// separate
 	// -----------------------------------------------
@@ -369,53 +540,228 @@ namespace ds {
 	// stop action
 	// -----------------------------------------------
 	void World::stopAction(ID id, ActionType type) {
-		_actionManager->stopAction(id, type);
+		if (type == AT_MOVE_WITH) {
+			_hierarchy->detach(id);
+		}
+		else {
+			_actionManager->stopAction(id, type);
+		}
 	}
 
 	// -----------------------------------------------
 	// is active
 	// -----------------------------------------------
 	bool World::isActive(ID id, ActionType type) {
+		if (type == AT_MOVE_WITH) {
+			return _hierarchy->contains(id);
+		}
 		return _actionManager->isActive(id, type);
 	}
 
+	// -----------------------------------------------
+	// set tween mode
+	// -----------------------------------------------
+	void World::setTweenMode(TweenMode mode) {
+		_actionManager->setTweenMode(mode);
+	}
+
+	// -----------------------------------------------
+	// fused actions - all actions are walking the 
+	// channels in memory order
+	// -----------------------------------------------
+	void World::setFusedActions(bool fused) {
+		_actionManager->setFused(fused);
+	}
+
+	// -----------------------------------------------
+	// set job system - actions with disjoint channel
+	// sets are updated concurrently on the job system
+	// -----------------------------------------------
+	void World::setJobSystem(JobSystem* jobs) {
+		_actionManager->setJobSystem(jobs);
+	}
+
+	// -----------------------------------------------
+	// enable snapshots - channels is a mask of 
+	// WorldEntityChannels. No reader may hold a 
+	// snapshot while this is called.
+	// -----------------------------------------------
+	void World::enableSnapshots(uint32_t channels, int buffers) {
+		if (_snapshots != 0) {
+			delete _snapshots;
+		}
+		_snapshots = new WorldSnapshots(channels, buffers);
+	}
+
+	void World::setView(const Rect& view) {
+		_actionManager->getLOD().setView(view);
+	}
+
+	// -----------------------------------------------
+	// set LOD bands - band 0 should cover the view
+	// with distance 0 and interval 1. No bands turns
+	// the LOD off.
+	// -----------------------------------------------
+	void World::setLODBands(const LODBand* bands, int num) {
+		_actionManager->getLOD().setBands(bands, num);
+	}
+
+	void World::setUpdateBudget(ActionType type, uint32_t rows) {
+		_actionManager->get(type)->setBudget(rows);
+	}
+
+	// -----------------------------------------------
+	// set sleeping - disabling wakes all entities
+	// -----------------------------------------------
+	void World::setSleeping(bool sleeping) {
+		_sleeping = sleeping;
+		if (!sleeping) {
+			_data->awake = _data->size;
+		}
+	}
+
+	bool World::isSleeping(ID id) const {
+		return _data->contains(id) && !_data->isAwake(id);
+	}
+
+	void World::wake(ID id) {
+		_data->wake(id);
+	}
+
+	// -----------------------------------------------
+	// track changes - channels is a mask of 
+	// WorldEntityChannels or custom channels
+	// -----------------------------------------------
+	void World::trackChanges(uint32_t channels) {
+		_dirty.track(channels);
+	}
+
+	// -----------------------------------------------
+	// materialize - writes all lazy tweens into the 
+	// channels. The tick and the getters do this on
+	// their own. Call it before reading the channels
+	// directly when using TM_LAZY.
+	// -----------------------------------------------
+	void World::materialize() {
+		syncTweens();
+	}
+
+	// -----------------------------------------------
+	// sync tweens - only writes if the lazy tweens 
+	// have advanced since the last call
+	// -----------------------------------------------
+	void World::syncTweens() const {
+		if (_tweensPending) {
+			_actionManager->materialize();
+			_tweensPending = false;
+		}
+	}
+
+	// -----------------------------------------------
+	// extract sprites - writes a packed instance for
+	// every entity overlapping the view and returns
+	// the number of instances. The optional keys can
+	// be sorted with RadixSort to get the draw order
+	// -----------------------------------------------
+	int World::extractSprites(SpriteInstance* out, int max, const Rect& view, uint64_t* keys) {
+		ZoneTracker z("World::extractSprites");
+		materialize();
+		return sprites::extract(_data, out, max, view, keys);
+	}
+
+	static void tickWorld(void* data, float dt) {
+		World* world = (World*)data;
+		world->tick(dt);
+	}
+
+	// -----------------------------------------------
+	// add task - the world runs on the main thread and
+	// uses the job system itself
+	// -----------------------------------------------
+	int World::addTask(FrameGraph* graph) {
+		return graph->add("World::tick", tickWorld, this, FTF_MAIN_THREAD);
+	}
+
 	// -----------------------------------------------
 	// tick
 	// -----------------------------------------------
 	void World::tick(float dt) {
 		ZoneTracker m("World::tick");
 		_buffer.reset();
-		// reset forces
-		v3* forces = (v3*)_data->get_ptr(WEC_FORCE);		
-		for (uint32_t i = 0; i < _data->size; ++i) {
-			*forces = v3(0.0f);
-			++forces;
+		// reset forces - sleeping entities have no force. The forces stay
+		// readable until the next tick.
+		v3* forces = (v3*)_data->get_ptr(WEC_FORCE);
+		for (int i = 0; i < _data->awake; ++i) {
+			forces[i] = v3(0.0f);
 		}
 
+		_timelines->tick(dt);
+		_scripts->tick();
+
 		_actionManager->update(dt, _buffer);
 		
 		// update all custom actions
 		{
 			ZoneTracker u2("World::tick::updateCustom");
 			for (uint32_t i = 0; i < _customActions.size(); ++i) {
-				_customActions[i]->update(dt, _buffer);
+				_customActions[i]->updateLOD(dt, _buffer, _actionManager->getLOD());
 			}
 		}
-		
 
-		_behaviors->tick(dt);
+		// expired timers of actions and behaviors
+		{
+			ZoneTracker tm("World::tick::timers");
+			_expiredTimers.clear();
+			_timers.advance(dt, _expiredTimers);
+			dispatchTimers();
+		}
+		_tweensPending = _actionManager->getTweenMode() == TM_LAZY;
 
-		// apply forces
+		// apply forces - sleeping entities have no force
 		{
 			ZoneTracker af("World::tick::applyForces");
+			int num = _data->awake;
 			forces = (v3*)_data->get_ptr(WEC_FORCE);
 			v3* positions = (v3*)_data->get_ptr(WEC_POSITION);
-			for (uint32_t i = 0; i < _data->size; ++i) {
-				*positions += *forces;
-				++forces;
-				++positions;
+			bool track = _sleeping || (_dirty.getTracked() & WEC_MASK(WEC_POSITION)) != 0;
+			if (track && num > _movedCapacity) {
+				if (_moved != 0) {
+					DEALLOC(_moved);
+				}
+				_movedCapacity = num * 2 + 16;
+				_moved = (uint8_t*)ALLOC(_movedCapacity);
+			}
+			// a lazy tween would overwrite the applied forces
+			if (_tweensPending && forces::any(forces, num)) {
+				syncTweens();
+			}
+			forces::apply(positions, forces, num, track ? _moved : 0);
+			if (_sleeping) {
+				uint32_t words = (_data->capacity + 31) / 32;
+				_active.clear();
+				for (uint32_t i = 0; i < words; ++i) {
+					_active.push_back(0);
+				}
+			}
+			if (track) {
+				for (int i = 0; i < num; ++i) {
+					if (_moved[i] != 0) {
+						ID id = _data->getID(i);
+						_dirty.mark(id, WEC_MASK(WEC_POSITION));
+						if (_sleeping) {
+							_active[id >> 5] |= 1u << (id & 31);
+						}
+					}
+				}
 			}
 		}
+		// lazy tweens are written before anything reads the channels so
+		// that TM_LAZY does not change what the simulation observes
+		if (_hierarchy->size() > 0 || _actionManager->supportCollisions()) {
+			syncTweens();
+		}
+		// children are following their parents before collisions are checked
+		_hierarchy->update(&_dirty);
 		// handle collisions
 		{
 			ZoneTracker cl("World::tick::collisions");
@@ -429,14 +775,96 @@ namespace ds {
 		// process events / kill entities
 		{
 			ZoneTracker ev("World::tick::events");
+			if (_buffer.events.size() > 0) {
+				syncTweens();
+			}
 			for (uint32_t i = 0; i < _buffer.events.size(); ++i) {
 				const ActionEvent& e = _buffer.events[i];
+				// scripts waiting for AT_KILL need to see it before the entity is removed
+				_scripts->processEvent(e);
+				_timelines->processEvent(e);
 				if (e.action == AT_KILL) {
 					remove(e.id);
 				}
 				_behaviors->processEvent(e);
 			}
 		}
+
+		if (_sleeping) {
+			updateActivity();
+		}
+
+		if (_snapshots != 0) {
+			ZoneTracker sn("World::tick::snapshot");
+			syncTweens();
+			_snapshots->publish(_data);
+		}
+		_dirty.publish();
+	}
+
+	// -----------------------------------------------
+	// update activity - awake entities without any
+	// action, force, collision or moving parent are 
+	// put to sleep. Entities moved by a force were
+	// marked by the apply pass. The rows are visited 
+	// backwards so every row swapped in was already 
+	// checked.
+	// -----------------------------------------------
+	void World::updateActivity() {
+		ZoneTracker z("World::tick::activity");
+		// entities created by events may have grown the array
+		uint32_t words = (_data->capacity + 31) / 32;
+		while (_active.size() < words) {
+			_active.push_back(0);
+		}
+		uint32_t* bits = _active.data();
+		_actionManager->markActive(bits);
+		for (uint32_t i = 0; i < _customActions.size(); ++i) {
+			_customActions[i]->markActive(bits);
+		}
+		_hierarchy->markActive(bits);
+		if (_actionManager->supportCollisions()) {
+			CollisionAction* collisionAction = _actionManager->getCollisionAction();
+			for (uint32_t i = 0; i < collisionAction->numCollisions(); ++i) {
+				const Collision& c = collisionAction->getCollision(i);
+				ID ids[] = { c.firstID, c.secondID };
+				for (int j = 0; j < 2; ++j) {
+					if (_data->contains(ids[j])) {
+						_data->wake(ids[j]);
+						bits[ids[j] >> 5] |= 1u << (ids[j] & 31);
+					}
+				}
+			}
+		}
+		for (int i = _data->awake - 1; i >= 0; --i) {
+			ID id = _data->getID(i);
+			if ((bits[id >> 5] & (1u << (id & 31))) == 0) {
+				_data->sleep(id);
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// dispatch expired timers to their owners
+	// -----------------------------------------------
+	void World::dispatchTimers() {
+		for (uint32_t i = 0; i < _expiredTimers.size(); ++i) {
+			const TimerEvent& e = _expiredTimers[i];
+			if (e.owner == TO_ACTION) {
+				_actionManager->onTimer(e, _buffer);
+			}
+			else if (e.owner == TO_CUSTOM_ACTION) {
+				_customActions[e.type]->onTimer(e, _buffer);
+			}
+			else if (e.owner == TO_BEHAVIOR) {
+				if (_data->contains(e.id)) {
+					_behaviors->onTimer(e, channels::getType(_data, e.id));
+				}
+			}
+			else if (e.owner == TO_SCRIPT) {
+				_scripts->onTimer(e);
+			}
+		}
 	}
 
 	void World::generateJSON(std::string& resp) {
@@ -480,11 +908,11 @@ namespace ds {
 				writer.addCell(i);
 				writer.addCell(indices[i]);
 				writer.addCell(_data->get<v3>(i, WEC_POSITION));
-				writer.addCell(_data->get<Texture>(i, WEC_TEXTURE));
-				writer.addCell(RADTODEG(_data->get<v3>(i, WEC_ROTATION).x));
-				writer.addCell(_data->get<v3>(i, WEC_SCALE));
-				writer.addCell(_data->get<Color>(i, WEC_COLOR));
-				writer.addCell(_data->get<int>(i, WEC_TYPE));
+				writer.addCell(channels::getTexture(_data, i));
+				writer.addCell(RADTODEG(channels::getRotation(_data, i).x));
+				writer.addCell(channels::getScale(_data, i));
+				writer.addCell(channels::getColor(_data, i));
+				writer.addCell(channels::getType(_data, i));
 				writer.addCell(_data->get<v3>(i, WEC_FORCE));
 				int idx = _data->get<int>(i, WEC_NAME);
 				if (idx != -1) {
@@ -571,4 +999,55 @@ namespace ds {
 		}
 	}
 
+	// -----------------------------------------------
+	// set behavior ttl
+	// -----------------------------------------------
+	void World::setBehaviorTTL(ID behaviorID, float ttl, float variance) {
+		_behaviors->setTTL(behaviorID, ttl, variance);
+	}
+
+	// -----------------------------------------------
+	// create timeline
+	// -----------------------------------------------
+	ID World::createTimeline(const char* name) {
+		return _timelines->create(name);
+	}
+
+	// -----------------------------------------------
+	// add action to timeline and wait until it is done
+	// -----------------------------------------------
+	void World::addSequence(ID timeline, ActionSettings* settings) {
+		_timelines->add(timeline, settings);
+	}
+
+	// -----------------------------------------------
+	// add actions running in parallel to timeline
+	// -----------------------------------------------
+	void World::addParallel(ID timeline, ActionSettings** settings, int num) {
+		_timelines->addParallel(timeline, settings, num);
+	}
+
+	void World::addWait(ID timeline, float ttl) {
+		_timelines->wait(timeline, ttl);
+	}
+
+	void World::addRepeat(ID timeline, int times) {
+		_timelines->repeat(timeline, times);
+	}
+
+	// -----------------------------------------------
+	// start timeline
+	// -----------------------------------------------
+	void World::startTimeline(const StaticHash& hash, ID id) {
+		_timelines->start(hash, id);
+	}
+
+	void World::stopTimeline(ID id) {
+		_timelines->stop(id);
+	}
+
+	bool World::isTimelineActive(ID id) const {
+		return _timelines->isActive(id);
+	}
+
 }
\ No newline at end of file
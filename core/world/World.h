@@ -12,6 +12,14 @@
 #include "WorldEntityTemplates.h"
 #include "ActionManager.h"
 #include "Behaviors.h"
+#include "Timeline.h"
+#include "WorldScript.h"
+#include "TimerWheel.h"
+#include "WorldSnapshot.h"
+#include "TransformHierarchy.h"
+#include "ChannelView.h"
+#include "DirtyChannels.h"
+#include "TextureTable.h"
 
 namespace ds {
 
@@ -25,15 +33,40 @@ namespace ds {
 	enum WorldEntityChannel {
 		WEC_POSITION,WEC_SCALE,WEC_ROTATION,WEC_TEXTURE,WEC_COLOR,WEC_TIMER,WEC_TYPE,WEC_FORCE,WEC_NAME,WEC_HASH
 	};
+
+	// -----------------------------------------------
+	// WorldStorage - WS_COMPACT stores scale as half
+	// floats, rotation as one float, the texture as
+	// 16 bit index into the shared texture table, the
+	// color as RGBA8 and the type as 16 bit integer.
+	// The channels are accessed by EntityChannels.h.
+	// Every world has its own texture table.
+	// WS_ARCHETYPE keeps the entity channels of 
+	// WS_FULL but stores the custom channels in an
+	// ArchetypeStorage. Entities with the same set of
+	// custom channels share 16 KB chunks and setting
+	// or detaching a channel moves the entity.
+	// -----------------------------------------------
+	enum WorldStorage {
+		WS_FULL,
+		WS_COMPACT,
+		WS_ARCHETYPE
+	};
 	
 	class AbstractAction;
 	class CollisionAction;
+	class Path;
+	class CubicBezierPath;
+	class StraightPath;
+	class JobSystem;
+	class FrameGraph;
+	struct SpriteInstance;
 	struct ActionSettings;
 
 	class World {
 
 	public:
-		World();
+		World(WorldStorage storage = WS_FULL);
 		~World();
 		void setWorldDimension(const v2& dim);
 		void setBoundingRect(const Rect& r);
@@ -56,6 +89,9 @@ namespace ds {
 		void moveBy(ID id, const v3& velocity, float ttl = -1.0f, bool bounce = true);
 		void moveTo(ID id, const v3& start, const v3& end, float ttl, const tweening::TweeningType& tweeningType = &tweening::linear);
 		void scaleByPath(ID id, V3Path* path, float ttl);
+		void followPath(ID id, Path* path, float ttl, int mode = 0, bool rotate = true);
+		void followCurve(ID id, CubicBezierPath* path, float ttl, int mode = 0, bool rotate = true);
+		void followStraightPath(ID id, StraightPath* path, float ttl, int mode = 0, bool rotate = true);
 		void scale(ID id, const v3& start, const v3& end, float ttl, int mode = 0, const tweening::TweeningType& tweeningType = &tweening::linear);
 		void scaleAxes(ID id, int axes, float start, float end, float ttl, int mode = 0, const tweening::TweeningType& tweeningType = &tweening::linear);
 		void removeAfter(ID sid, float ttl);
@@ -69,19 +105,50 @@ namespace ds {
 		void stopAction(ID id, ActionType type);
 		bool isActive(ID id, ActionType type);
 		void flashColor(ID id, const Color& startColor, const Color& endColor, float ttl, int mode = 0, const tweening::TweeningType& tweeningType = &tweening::linear);
+		void moveWith(ID id, ID parent, const v2& offset, float rotation = 0.0f);
+		void setLocalPosition(ID id, const v2& offset);
+		void setLocalRotation(ID id, float rotation);
 
 		void setPosition(ID id, const v2& pos);
 		void setPosition(ID id, const v3& pos);
 		const v3& getPosition(ID id) const;
 		void setRotation(ID id, const v3& rotation);
 		void setRotation(ID id, float rotation);
-		const v3& getRotation(ID id) const;
+		// rotation and scale are returned by value since WS_COMPACT packs them
+		v3 getRotation(ID id) const;
 		void setColor(ID id, const Color& color);
-		const v3& getScale(ID id) const;
+		v3 getScale(ID id) const;
+		// WS_FULL only - references into the channels like before
+		const v3& getRotationRef(ID id) const;
+		const v3& getScaleRef(ID id) const;
 		void setScale(ID id, const v3& s);
 		int getType(ID id) const;
 		void setTexture(ID id, const Texture& texture);
 		void tick(float dt);
+		int addTask(FrameGraph* graph);
+		void setTweenMode(TweenMode mode);
+		void setFusedActions(bool fused);
+		void setJobSystem(JobSystem* jobs);
+		// chunked actions update entities outside of the view at the rate of their LOD band
+		void setView(const Rect& view);
+		void setLODBands(const LODBand* bands, int num);
+		void setUpdateBudget(ActionType type, uint32_t rows);
+		// idle entities are moved into the sleeping rows and skipped by forces and collisions
+		void setSleeping(bool sleeping);
+		bool isSleeping(ID id) const;
+		void wake(ID id);
+		// publishes a snapshot of the selected channels at the end of every tick
+		void enableSnapshots(uint32_t channels, int buffers = MAX_SNAPSHOT_BUFFERS);
+		WorldSnapshots* getSnapshots() const {
+			return _snapshots;
+		}
+		// records which entities changed the selected channels during a tick
+		void trackChanges(uint32_t channels);
+		const DirtyChannels& getDirtyChannels() const {
+			return _dirty;
+		}
+		void materialize();
+		int extractSprites(SpriteInstance* out, int max, const Rect& view, uint64_t* keys = 0);
 		void remove(ID id);
 		void removeByType(int type);
 		ChannelArray* getChannelArray() const {
@@ -99,6 +166,93 @@ namespace ds {
 			return _additionalData.get(sid);
 		}
 
+		// custom channels - typed per entity data stored as additional channels
+		template<class T>
+		int registerChannel(const char* name) {
+			return addCustomChannel(name, &CustomChannelType<T>::key, sizeof(T));
+		}
+
+		template<class T>
+		void set(ID id, const T& t) {
+			const CustomChannel& c = getCustomChannel(&CustomChannelType<T>::key);
+			if (_components != 0) {
+				if (!_components->contains(id)) {
+					_components->add(id, c.bit);
+				}
+				else {
+					_components->addComponents(id, c.bit);
+				}
+				_components->set<T>(id, c.component, t);
+			}
+			else {
+				_data->set<T>(id, c.channel, t);
+				_data->get<uint32_t>(id, _presence) |= c.bit;
+			}
+			_data->wake(id);
+			_dirty.mark(id, WEC_MASK(c.channel));
+		}
+
+		template<class T>
+		T& get(ID id) {
+			const CustomChannel& c = getCustomChannel(&CustomChannelType<T>::key);
+			if (_components != 0) {
+				return _components->get<T>(id, c.component);
+			}
+			return _data->get<T>(id, c.channel);
+		}
+
+		template<class T>
+		bool has(ID id) const {
+			const CustomChannel& c = getCustomChannel(&CustomChannelType<T>::key);
+			if (_components != 0) {
+				return _components->contains(id) && _components->has(id, c.component);
+			}
+			return (_data->get<uint32_t>(id, _presence) & c.bit) != 0;
+		}
+
+		template<class T>
+		void detach(ID id) {
+			const CustomChannel& c = getCustomChannel(&CustomChannelType<T>::key);
+			if (_components != 0) {
+				if (!_components->contains(id)) {
+					return;
+				}
+				// entities without any component leave the storage
+				if ((_components->getComponents(id) & ~c.bit) == 0) {
+					_components->remove(id);
+				}
+				else {
+					_components->removeComponents(id, c.bit);
+				}
+			}
+			else {
+				_data->get<uint32_t>(id, _presence) &= ~c.bit;
+			}
+			_dirty.mark(id, WEC_MASK(c.channel));
+		}
+
+		template<class T>
+		ChannelView<T> view() {
+			const CustomChannel& c = getCustomChannel(&CustomChannelType<T>::key);
+			if (_components != 0) {
+				return ChannelView<T>(_components, c.component);
+			}
+			return ChannelView<T>(_data, c.channel, _presence, c.bit);
+		}
+
+		// WS_ARCHETYPE only - the component index of a custom channel for queries
+		template<class T>
+		int getComponent() const {
+			return getCustomChannel(&CustomChannelType<T>::key).component;
+		}
+
+		// the storage of the custom channels - 0 unless WS_ARCHETYPE
+		ArchetypeStorage* getComponents() const {
+			return _components;
+		}
+
+		int findChannel(const char* name) const;
+
 		bool hasEvents() const {
 			return !_buffer.events.empty();
 		}
@@ -118,6 +272,8 @@ namespace ds {
 		template<class T>
 		T* addCustomAction(const char* name) {
 			T* t = new T(_data, _boundingRect, name);
+			t->setTimerWheel(&_timers, TO_CUSTOM_ACTION, _customActions.size());
+			t->setDirtyChannels(&_dirty);
 			_customActions.push_back(t);
 			return t;
 		}
@@ -131,7 +287,36 @@ namespace ds {
 		void connectBehaviors(ID first, const ActionType& type, ID second, int objectType);
 		void connectBehaviors(ConnectionDefinition* definitions, int num, int objectType);
 		void connectBehaviors(StaticHash first, const ActionType& type, StaticHash second, int objectType);
+		void setBehaviorTTL(ID behaviorID, float ttl, float variance = 0.0f);
+
+		ID createTimeline(const char* name);
+		void addSequence(ID timeline, ActionSettings* settings);
+		void addParallel(ID timeline, ActionSettings** settings, int num);
+		void addWait(ID timeline, float ttl);
+		void addRepeat(ID timeline, int times = -1);
+		void startTimeline(const StaticHash& hash, ID id);
+		void stopTimeline(ID id);
+		bool isTimelineActive(ID id) const;
+
+		template<class T>
+		void startScript(const T& script) {
+			_scripts->start(script);
+		}
 	private:
+		struct CustomChannel {
+			StaticHash name;
+			const void* type;
+			// ChannelArray channel or the dirty channel of a component
+			int channel;
+			// index in the ArchetypeStorage or -1
+			int component;
+			uint32_t bit;
+		};
+		int addCustomChannel(const char* name, const void* type, int size);
+		const CustomChannel& getCustomChannel(const void* type) const;
+		void dispatchTimers();
+		void updateActivity();
+		void syncTweens() const;
 		int _numChannels;
 		AdditionalData _additionalData;
 		ChannelArray* _data;
@@ -141,6 +326,26 @@ namespace ds {
 		Rect _boundingRect;
 		WorldEntityTemplates* _templates;
 		Behaviors* _behaviors;
+		Timelines* _timelines;
+		Scripts* _scripts;
+		TimerWheel _timers;
+		Array<TimerEvent> _expiredTimers;
+		WorldSnapshots* _snapshots;
+		TransformHierarchy* _hierarchy;
+		Array<CustomChannel> _customChannels;
+		int _presence;
+		// custom channels of WS_ARCHETYPE
+		ArchetypeStorage* _components;
+		DirtyChannels _dirty;
+		bool _sleeping;
+		// lazy tweens have advanced since the last materialize
+		mutable bool _tweensPending;
+		Array<uint32_t> _active;
+		// textures of WS_COMPACT storage
+		TextureTable _textures;
+		// rows with a non zero force in the last apply pass
+		uint8_t* _moved;
+		int _movedCapacity;
 	};
 
 }
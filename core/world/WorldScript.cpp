@@ -0,0 +1,181 @@
+#include "WorldScript.h"
+#include "World.h"
+#include "..\profiler\Profiler.h"
+
+namespace ds {
+
+	// -----------------------------------------------
+	// script pool
+	// -----------------------------------------------
+	ScriptPool::~ScriptPool() {
+		for (uint32_t i = 0; i < _chunks.size(); ++i) {
+			DEALLOC(_chunks[i]);
+		}
+	}
+
+	void* ScriptPool::allocate() {
+		if (_free == 0) {
+			char* chunk = (char*)ALLOC(SCRIPT_BLOCK_SIZE * SCRIPT_BLOCKS_PER_CHUNK);
+			_chunks.push_back(chunk);
+			for (int i = 0; i < SCRIPT_BLOCKS_PER_CHUNK; ++i) {
+				release(chunk + i * SCRIPT_BLOCK_SIZE);
+			}
+		}
+		void* ret = _free;
+		_free = *(void**)_free;
+		return ret;
+	}
+
+	void ScriptPool::release(void* p) {
+		*(void**)p = _free;
+		_free = p;
+	}
+
+	Scripts::Scripts(World* world, TimerWheel* timers) : _world(world) , _timers(timers) , _free(-1) , _numActive(0) {
+	}
+
+	Scripts::~Scripts() {
+		for (uint32_t i = 0; i < _entries.size(); ++i) {
+			if (_entries[i].active) {
+				_entries[i].script->~WorldScript();
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// start - the script runs until the first await
+	// -----------------------------------------------
+	void Scripts::start(WorldScript* script) {
+		int index = _free;
+		if (index != -1) {
+			_free = _entries[index].next;
+		}
+		else {
+			ScriptEntry entry;
+			_entries.push_back(entry);
+			index = _entries.size() - 1;
+		}
+		ScriptEntry& e = _entries[index];
+		e.script = script;
+		e.ctx = ScriptContext();
+		e.timer = INVALID_TIMER;
+		e.next = -1;
+		e.active = true;
+		++_numActive;
+		resume(index);
+	}
+
+	// -----------------------------------------------
+	// tick - resumes all scripts that have yielded
+	// -----------------------------------------------
+	void Scripts::tick() {
+		if (!_ready.empty()) {
+			ZoneTracker z("World::tick::scripts");
+			_resume.clear();
+			for (uint32_t i = 0; i < _ready.size(); ++i) {
+				_resume.push_back(_ready[i]);
+			}
+			_ready.clear();
+			for (uint32_t i = 0; i < _resume.size(); ++i) {
+				resume(_resume[i]);
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// process event - resume all scripts waiting for it
+	// -----------------------------------------------
+	void Scripts::processEvent(const ActionEvent& event) {
+		if (event.id >= _waiting.size() || _waiting[event.id] == -1) {
+			return;
+		}
+		// detach the list since resumed scripts might wait again
+		int current = _waiting[event.id];
+		_waiting[event.id] = -1;
+		while (current != -1) {
+			ScriptEntry& e = _entries[current];
+			int next = e.next;
+			if (e.ctx.waitAction == event.action) {
+				e.next = -1;
+				resume(current);
+			}
+			else {
+				e.next = _waiting[event.id];
+				_waiting[event.id] = current;
+			}
+			current = next;
+		}
+	}
+
+	// -----------------------------------------------
+	// on timer
+	// -----------------------------------------------
+	void Scripts::onTimer(const TimerEvent& e) {
+		ScriptEntry& entry = _entries[e.data];
+		if (entry.active && entry.timer == e.handle) {
+			entry.timer = INVALID_TIMER;
+			resume(e.data);
+		}
+	}
+
+	// -----------------------------------------------
+	// remove by id - scripts waiting for an event of 
+	// this entity will never be resumed so they are
+	// destroyed
+	// -----------------------------------------------
+	void Scripts::removeByID(ID id) {
+		if (id < _waiting.size()) {
+			int current = _waiting[id];
+			_waiting[id] = -1;
+			while (current != -1) {
+				int next = _entries[current].next;
+				destroy(current);
+				current = next;
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// resume script and register the next wait
+	// -----------------------------------------------
+	void Scripts::resume(int index) {
+		// the script might start other scripts and the entries might be moved
+		ScriptContext ctx = _entries[index].ctx;
+		ScriptState state = _entries[index].script->run(*_world, ctx);
+		ScriptEntry& e = _entries[index];
+		e.ctx = ctx;
+		if (state == SS_DONE) {
+			destroy(index);
+		}
+		else if (state == SS_WAIT_EVENT) {
+			ID id = e.ctx.waitID;
+			while (_waiting.size() <= id) {
+				_waiting.push_back(-1);
+			}
+			e.next = _waiting[id];
+			_waiting[id] = index;
+		}
+		else if (state == SS_WAIT_TIME) {
+			e.timer = _timers->schedule(e.ctx.waitTime, INVALID_ID, TO_SCRIPT, 0, index);
+		}
+		else {
+			_ready.push_back(index);
+		}
+	}
+
+	// -----------------------------------------------
+	// destroy script and release the entry
+	// -----------------------------------------------
+	void Scripts::destroy(int index) {
+		ScriptEntry& e = _entries[index];
+		_timers->cancel(e.timer);
+		e.script->~WorldScript();
+		_pool.release(e.script);
+		e.script = 0;
+		e.active = false;
+		e.next = _free;
+		_free = index;
+		--_numActive;
+	}
+
+}
\ No newline at end of file
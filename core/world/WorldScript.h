@@ -0,0 +1,136 @@
+#pragma once
+#include <new>
+#include "..\Common.h"
+#include "..\lib\collection_types.h"
+#include "ActionEventBuffer.h"
+#include "TimerWheel.h"
+
+namespace ds {
+
+	class World;
+
+	enum ScriptState {
+		SS_READY,
+		SS_WAIT_EVENT,
+		SS_WAIT_TIME,
+		SS_DONE
+	};
+
+	struct ScriptContext {
+		int line;
+		ID waitID;
+		ActionType waitAction;
+		float waitTime;
+
+		ScriptContext() : line(0), waitID(INVALID_ID), waitAction(AT_WAIT), waitTime(0.0f) {}
+	};
+
+	// -----------------------------------------------
+	// WorldScript
+	//
+	// Base class of scripted sequences. run is resumed
+	// at the last await. Since the function is left at
+	// every await all state must be stored in members.
+	// Only one await per line is allowed and Edit and
+	// Continue (/ZI) must be off since the awaits are 
+	// based on __LINE__.
+	//
+	// struct Intro : public WorldScript {
+	//     ID id;
+	//     ScriptState run(World& world, ScriptContext& ctx) {
+	//         SCRIPT_BEGIN(ctx);
+	//         world.moveTo(id, v3(100, 100, 0), v3(500, 300, 0), 1.0f);
+	//         SCRIPT_AWAIT_EVENT(ctx, id, AT_MOVE_TO);
+	//         SCRIPT_AWAIT_TIME(ctx, 0.5f);
+	//         world.removeAfter(id, 0.2f);
+	//         SCRIPT_END(ctx);
+	//     }
+	// };
+	// -----------------------------------------------
+	class WorldScript {
+
+	public:
+		virtual ~WorldScript() {}
+		virtual ScriptState run(World& world, ScriptContext& ctx) = 0;
+	};
+
+#define SCRIPT_BEGIN(ctx) switch ((ctx).line) { case 0:
+
+#define SCRIPT_AWAIT_EVENT(ctx, id, action) do { (ctx).line = __LINE__; (ctx).waitID = (id); (ctx).waitAction = (action); return SS_WAIT_EVENT; case __LINE__: ; } while (0)
+
+#define SCRIPT_AWAIT_TIME(ctx, ttl) do { (ctx).line = __LINE__; (ctx).waitTime = (ttl); return SS_WAIT_TIME; case __LINE__: ; } while (0)
+
+#define SCRIPT_YIELD(ctx) do { (ctx).line = __LINE__; return SS_READY; case __LINE__: ; } while (0)
+
+#define SCRIPT_END(ctx) } (ctx).line = -1; return SS_DONE
+
+	const int SCRIPT_BLOCK_SIZE = 256;
+	const int SCRIPT_BLOCKS_PER_CHUNK = 64;
+
+	// -----------------------------------------------
+	// fixed size block pool for the script objects
+	// -----------------------------------------------
+	class ScriptPool {
+
+	public:
+		ScriptPool() : _free(0) {}
+		~ScriptPool();
+		void* allocate();
+		void release(void* p);
+	private:
+		Array<char*> _chunks;
+		void* _free;
+	};
+
+	struct ScriptEntry {
+		WorldScript* script;
+		ScriptContext ctx;
+		TimerHandle timer;
+		int next;
+		bool active;
+	};
+
+	// -----------------------------------------------
+	// Scripts
+	//
+	// Scheduler for the scripts of a world. Waiting 
+	// scripts are only touched when the awaited event
+	// arrives or their timer expires. Only scripts 
+	// using SCRIPT_YIELD are resumed every tick.
+	// -----------------------------------------------
+	class Scripts {
+
+	public:
+		Scripts(World* world, TimerWheel* timers);
+		~Scripts();
+		template<class T>
+		void start(const T& script) {
+			static_assert(sizeof(T) <= SCRIPT_BLOCK_SIZE, "The script is too large");
+			void* mem = _pool.allocate();
+			T* t = new (mem) T(script);
+			start(static_cast<WorldScript*>(t));
+		}
+		void tick();
+		void processEvent(const ActionEvent& event);
+		void onTimer(const TimerEvent& e);
+		void removeByID(ID id);
+		uint32_t size() const {
+			return _numActive;
+		}
+	private:
+		void start(WorldScript* script);
+		void resume(int index);
+		void destroy(int index);
+		World* _world;
+		TimerWheel* _timers;
+		ScriptPool _pool;
+		Array<ScriptEntry> _entries;
+		int _free;
+		uint32_t _numActive;
+		// entity ID -> first entry waiting for an event
+		Array<int> _waiting;
+		Array<int> _ready;
+		Array<int> _resume;
+	};
+
+}
\ No newline at end of file
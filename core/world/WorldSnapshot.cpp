@@ -0,0 +1,138 @@
+#include "WorldSnapshot.h"
+#include "..\memory\DefaultAllocator.h"
+#include <string.h>
+
+namespace ds {
+
+	WorldSnapshots::WorldSnapshots(uint32_t channels, int buffers) : _numBuffers(buffers), _channels(channels), _frame(0), _skipped(0), _latest(-1) {
+		assert(buffers >= 2 && buffers <= MAX_SNAPSHOT_BUFFERS);
+		for (int i = 0; i < MAX_SNAPSHOT_BUFFERS; ++i) {
+			WorldSnapshot& s = _snapshots[i];
+			s.frame = 0;
+			s.size = 0;
+			s.capacity = 0;
+			s.blocks = 0;
+			s.ids = 0;
+			s.data = 0;
+			s.textures = 0;
+			s.readers = 0;
+			for (int j = 0; j < MAX_BLOCKS; ++j) {
+				s.channels[j] = 0;
+			}
+		}
+	}
+
+	WorldSnapshots::~WorldSnapshots() {
+		for (int i = 0; i < MAX_SNAPSHOT_BUFFERS; ++i) {
+			assert(_snapshots[i].readers == 0);
+			if (_snapshots[i].data != 0) {
+				DEALLOC(_snapshots[i].data);
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// publish - copy into a buffer that is neither
+	// the latest one nor held by a reader
+	// -----------------------------------------------
+	void WorldSnapshots::publish(ChannelArray* data) {
+		++_frame;
+		int latest = _latest;
+		for (int i = 0; i < _numBuffers; ++i) {
+			WorldSnapshot* s = &_snapshots[i];
+			if (i != latest && s->readers == 0) {
+				copy(s, data);
+				s->frame = _frame;
+				_latest = i;
+				return;
+			}
+		}
+		++_skipped;
+	}
+
+	// -----------------------------------------------
+	// copy - the layout is rebuilt when the buffer is
+	// too small or a channel has been added since the
+	// last copy
+	// -----------------------------------------------
+	void WorldSnapshots::copy(WorldSnapshot* snapshot, ChannelArray* data) {
+		uint32_t size = data->size;
+		if (size > snapshot->capacity || snapshot->blocks != data->_num_blocks) {
+			if (snapshot->data != 0) {
+				DEALLOC(snapshot->data);
+			}
+			uint32_t capacity = size * 2 + 16;
+			int total = sizeof(ID);
+			for (int i = 0; i < data->_num_blocks; ++i) {
+				if ((_channels & (1 << i)) != 0) {
+					total += data->_sizes[i];
+				}
+			}
+			snapshot->data = (char*)ALLOC(capacity * total);
+			snapshot->capacity = capacity;
+			snapshot->blocks = data->_num_blocks;
+			char* p = snapshot->data;
+			snapshot->ids = (ID*)p;
+			p += capacity * sizeof(ID);
+			for (int i = 0; i < data->_num_blocks; ++i) {
+				snapshot->channels[i] = 0;
+				if ((_channels & (1 << i)) != 0) {
+					snapshot->channels[i] = p;
+					p += capacity * data->_sizes[i];
+				}
+			}
+		}
+		snapshot->size = size;
+		snapshot->textures = data->textures;
+		for (int i = 0; i < data->capacity; ++i) {
+			int index = data->_sparse[i];
+			if (index != -1) {
+				snapshot->ids[index] = i;
+			}
+		}
+		for (int i = 0; i < data->_num_blocks; ++i) {
+			if (snapshot->channels[i] != 0) {
+				int sz = data->_sizes[i];
+				const char* src = (const char*)data->get_ptr(i);
+				if (data->isCold(i)) {
+					// cold channels are indexed by ID
+					char* dst = snapshot->channels[i];
+					for (uint32_t j = 0; j < size; ++j) {
+						memcpy(dst + j * sz, src + snapshot->ids[j] * sz, sz);
+					}
+				}
+				else {
+					memcpy(snapshot->channels[i], src, size * sz);
+				}
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// acquire - the latest index is checked again after
+	// taking the reference so the writer cannot have 
+	// started to overwrite it
+	// -----------------------------------------------
+	const WorldSnapshot* WorldSnapshots::acquire() {
+		for (;;) {
+			int latest = _latest;
+			if (latest == -1) {
+				return 0;
+			}
+			WorldSnapshot* s = &_snapshots[latest];
+			++s->readers;
+			if (_latest == latest) {
+				return s;
+			}
+			--s->readers;
+		}
+	}
+
+	void WorldSnapshots::release(const WorldSnapshot* snapshot) {
+		if (snapshot != 0) {
+			WorldSnapshot* s = const_cast<WorldSnapshot*>(snapshot);
+			--s->readers;
+		}
+	}
+
+}
\ No newline at end of file
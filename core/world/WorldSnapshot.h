@@ -0,0 +1,67 @@
+#pragma once
+#include "..\lib\BlockArray.h"
+#include "TextureTable.h"
+#include <atomic>
+
+namespace ds {
+
+	const int MAX_SNAPSHOT_BUFFERS = 3;
+
+	// -----------------------------------------------
+	// WorldSnapshot - copy of the selected channels of
+	// one frame. Row i of every channel belongs to 
+	// ids[i]. Channels that are not selected are 0.
+	// The texture indices of compact storage are 
+	// resolved by textures (0 for full storage).
+	// -----------------------------------------------
+	struct WorldSnapshot {
+
+		uint32_t frame;
+		uint32_t size;
+		uint32_t capacity;
+		int blocks;
+		ID* ids;
+		char* channels[MAX_BLOCKS];
+		char* data;
+		const TextureTable* textures;
+		std::atomic<int> readers;
+
+		template<class T>
+		const T* get(int channel) const {
+			return (const T*)channels[channel];
+		}
+	};
+
+	// -----------------------------------------------
+	// WorldSnapshots - the simulation thread publishes
+	// a snapshot at the end of every tick and any 
+	// number of threads can read the latest one. The
+	// writer never touches a snapshot held by a reader.
+	// If all buffers are held the frame is skipped.
+	// -----------------------------------------------
+	class WorldSnapshots {
+
+	public:
+		WorldSnapshots(uint32_t channels, int buffers = MAX_SNAPSHOT_BUFFERS);
+		~WorldSnapshots();
+		void publish(ChannelArray* data);
+		// returns the latest snapshot or 0 - must be released
+		const WorldSnapshot* acquire();
+		void release(const WorldSnapshot* snapshot);
+		uint32_t getChannels() const {
+			return _channels;
+		}
+		uint32_t getSkipped() const {
+			return _skipped;
+		}
+	private:
+		void copy(WorldSnapshot* snapshot, ChannelArray* data);
+		WorldSnapshot _snapshots[MAX_SNAPSHOT_BUFFERS];
+		int _numBuffers;
+		uint32_t _channels;
+		uint32_t _frame;
+		uint32_t _skipped;
+		std::atomic<int> _latest;
+	};
+
+}
\ No newline at end of file
@@ -3,6 +3,12 @@
 
 namespace ds {
 
+	AbstractAction::~AbstractAction() {
+		if (_sortKeys != 0) {
+			DEALLOC(_sortKeys);
+		}
+	}
+
 	void AbstractAction::removeByIndex(int i) {
 		swap(i);
 	}
@@ -28,14 +34,63 @@ namespace ds {
 	// -------------------------------------------------------
 	ID AbstractAction::swap(int i) {
 		ID current = _ids[i];
+		if (_handles != 0) {
+			cancel(_handles[i]);
+		}
 		_buffer.remove(i);
+		if (_handles != 0 && (uint32_t)i < _buffer.size) {
+			// the last row has been moved to i
+			_wheel->setData(_handles[i], i);
+		}
 		return current;
 	}
 
+	// -------------------------------------------------------
+	// schedule timer for row
+	// -------------------------------------------------------
+	TimerHandle AbstractAction::schedule(ID id, int index, float ttl) {
+		assert(_wheel != 0);
+		return _wheel->schedule(ttl, id, _timerOwner, _timerType, index);
+	}
+
+	// -------------------------------------------------------
+	// cancel timer
+	// -------------------------------------------------------
+	void AbstractAction::cancel(TimerHandle handle) {
+		if (_wheel != 0) {
+			_wheel->cancel(handle);
+		}
+	}
+
+	// -------------------------------------------------------
+	// find the row of an expired timer - the row might have
+	// been moved or removed by another timer of the same tick
+	// -------------------------------------------------------
+	int AbstractAction::findTimer(const TimerEvent& e) {
+		if ((uint32_t)e.data < _buffer.size && _handles[e.data] == e.handle) {
+			return e.data;
+		}
+		for (uint32_t i = 0; i < _buffer.size; ++i) {
+			if (_handles[i] == e.handle) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
 	// -------------------------------------------------------
 	// create new entry
 	// -------------------------------------------------------
 	int AbstractAction::create(ID id) {
+		_array->wake(id);
+		// attach writes the start values
+		markRow(id);
+		setUpdated(id, _lodFrame);
+		uint32_t index = id & INDEX_MASK;
+		while (_attachments.size() <= index) {
+			_attachments.push_back(0);
+		}
+		_attachments[index] = ++_numAttachments;
 		int idx = find(id);
 		if (idx == -1) {
 			allocate(_buffer.size + 16);
@@ -48,9 +103,192 @@ namespace ds {
 	// 
 	// -------------------------------------------------------
 	void AbstractAction::clear() {
+		if (_handles != 0) {
+			for (uint32_t i = 0; i < _buffer.size; ++i) {
+				cancel(_handles[i]);
+			}
+		}
 		_buffer.size = 0;
 	}
 
+	// -------------------------------------------------------
+	// sort rows - radix sorts all rows by the dense index of 
+	// the entity so that the update loops are walking the
+	// channels in memory order
+	// -------------------------------------------------------
+	void AbstractAction::sortRows() {
+		uint32_t n = _buffer.size;
+		if (n < 2) {
+			return;
+		}
+		reserveSortKeys(n);
+		bool sorted = true;
+		for (uint32_t i = 0; i < n; ++i) {
+			_sortKeys[i] = (uint64_t)_array->_sparse[_ids[i] & INDEX_MASK];
+			if (i > 0 && _sortKeys[i] < _sortKeys[i - 1]) {
+				sorted = false;
+			}
+		}
+		if (sorted) {
+			return;
+		}
+		applyOrder(_sorter.sort(_sortKeys, n));
+	}
+
+	void AbstractAction::reserveSortKeys(uint32_t num) {
+		if (num > _sortCapacity) {
+			if (_sortKeys != 0) {
+				DEALLOC(_sortKeys);
+			}
+			_sortCapacity = num * 2;
+			_sortKeys = (uint64_t*)ALLOC(_sortCapacity * sizeof(uint64_t));
+		}
+	}
+
+	// -----------------------------------------------
+	// apply order - permutes all rows and moves the
+	// timer handles along
+	// -----------------------------------------------
+	void AbstractAction::applyOrder(const uint32_t* rows) {
+		_buffer.permute((const int*)rows);
+		if (_handles != 0) {
+			for (uint32_t i = 0; i < _buffer.size; ++i) {
+				if (_handles[i] != INVALID_TIMER) {
+					_wheel->setData(_handles[i], i);
+				}
+			}
+		}
+	}
+
+	// -----------------------------------------------
+	// set updated - the LOD frame of the last update of 
+	// the entity. Indexed by entity so it does not move
+	// with the rows.
+	// -----------------------------------------------
+	void AbstractAction::setUpdated(ID id, uint32_t frame) {
+		uint32_t index = id & INDEX_MASK;
+		while (_updated.size() <= index) {
+			_updated.push_back(0);
+		}
+		_updated[index] = frame;
+	}
+
+	// -----------------------------------------------
+	// update LOD - every row has a stable phase within
+	// the interval of its band (entity index % interval)
+	// and is due when the frame matches it. The due 
+	// rows are moved to the front, grouped by the 
+	// number of frames since their last update and in
+	// dense order. Every group is updated with the 
+	// real time elapsed since then. The budget 
+	// stretches the intervals of all bands. Actions 
+	// that cannot be updated in chunks run every frame.
+	// -----------------------------------------------
+	void AbstractAction::updateLOD(float dt, ActionEventBuffer& buffer, const ActionLOD& lod) {
+		uint32_t n = _buffer.size;
+		uint32_t frame = lod.getFrame();
+		if (!supportsChunks() || n == 0 || (!lod.isEnabled() && (_budget == 0 || n <= _budget))) {
+			if (writesOnUpdate()) {
+				markRows(0, n);
+			}
+			update(dt, buffer);
+			return;
+		}
+		// all rows have been updated by the last frame if it did not slice
+		if (_lodFrame + 1 != frame) {
+			_sliceStart = frame - 1;
+		}
+		_lodFrame = frame;
+		uint32_t counts[MAX_LOD_BANDS];
+		int intervals[MAX_LOD_BANDS];
+		int numBands = lod.isEnabled() ? lod.getNumBands() : 1;
+		for (int i = 0; i < numBands; ++i) {
+			counts[i] = 0;
+			intervals[i] = lod.isEnabled() ? lod.getInterval(i) : 1;
+		}
+		reserveSortKeys(n);
+		// the band is kept in the key until the intervals are known
+		for (uint32_t i = 0; i < n; ++i) {
+			int band = lod.isEnabled() ? lod.getBand(_array->get<v3>(_ids[i], WEC_POSITION)) : 0;
+			++counts[band];
+			_sortKeys[i] = band;
+		}
+		if (_budget > 0) {
+			uint32_t due = 0;
+			for (int i = 0; i < numBands; ++i) {
+				due += (counts[i] + intervals[i] - 1) / intervals[i];
+			}
+			if (due > _budget) {
+				int scale = (due + _budget - 1) / _budget;
+				for (int i = 0; i < numBands; ++i) {
+					intervals[i] = intervals[i] * scale < MAX_LOD_INTERVAL ? intervals[i] * scale : MAX_LOD_INTERVAL;
+				}
+			}
+		}
+		uint32_t numDue = 0;
+		bool sorted = true;
+		for (uint32_t i = 0; i < n; ++i) {
+			uint32_t index = _ids[i] & INDEX_MASK;
+			uint32_t interval = intervals[_sortKeys[i]];
+			uint64_t group = 0xffffffff;
+			if (index % interval == frame % interval) {
+				uint32_t last = index < _updated.size() && _updated[index] > _sliceStart ? _updated[index] : _sliceStart;
+				uint32_t age = frame - last;
+				group = age < 1 ? 1 : (age > MAX_LOD_INTERVAL ? MAX_LOD_INTERVAL : age);
+				++numDue;
+			}
+			_sortKeys[i] = (group << 32) | (uint64_t)_array->_sparse[index];
+			if (i > 0 && _sortKeys[i] < _sortKeys[i - 1]) {
+				sorted = false;
+			}
+		}
+		// the keys stay in the old row order
+		const uint32_t* order = 0;
+		if (!sorted) {
+			order = _sorter.sort(_sortKeys, n);
+			applyOrder(order);
+		}
+		uint32_t first = 0;
+		while (first < numDue) {
+			uint32_t age = (uint32_t)(_sortKeys[order != 0 ? order[first] : first] >> 32);
+			uint32_t last = first + 1;
+			while (last < numDue && (uint32_t)(_sortKeys[order != 0 ? order[last] : last] >> 32) == age) {
+				++last;
+			}
+			markRows(first, last);
+			_steps = (float)age;
+			updateChunk(lod.getElapsed(age), buffer, first, last);
+			first = last;
+		}
+		for (uint32_t i = 0; i < numDue; ++i) {
+			setUpdated(_ids[i], frame);
+		}
+		_steps = 1.0f;
+	}
+
+	// -----------------------------------------------
+	// mark rows
+	// -----------------------------------------------
+	void AbstractAction::markRows(uint32_t start, uint32_t end) const {
+		if (_dirty == 0) {
+			return;
+		}
+		uint32_t channels = getWriteChannels() & _dirty->getTracked();
+		if (channels == 0) {
+			return;
+		}
+		for (uint32_t i = start; i < end; ++i) {
+			_dirty->mark(_ids[i], channels);
+		}
+	}
+
+	void AbstractAction::markActive(uint32_t* bits) const {
+		for (uint32_t i = 0; i < _buffer.size; ++i) {
+			uint32_t index = _ids[i] & INDEX_MASK;
+			bits[index >> 5] |= 1u << (index & 31);
+		}
+	}
+
 	void AbstractAction::removeByID(ID id) {
 		int idx = find(id);
 		if (idx != -1) {
@@ -5,9 +5,24 @@
 #include "..\..\math\tweening.h"
 #include "..\..\lib\BlockArray.h"
 #include "..\..\io\ReportWriter.h"
+#include "..\TimerWheel.h"
+#include "..\..\lib\RadixSort.h"
+#include "..\DirtyChannels.h"
+#include "..\ActionLOD.h"
+#include "..\EntityChannels.h"
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#define DS_ACTION_PREFETCH
+#include <xmmintrin.h>
+#endif
 
 namespace ds {
 
+	// number of rows the update loops are fetching ahead
+	const int ACTION_PREFETCH_DISTANCE = 8;
+
+	#define WEC_MASK(c) (1 << (c))
+	const uint32_t ALL_CHANNELS = 0xffffffff;
+
 	struct ActionSettings {
 
 		ActionType type;
@@ -19,12 +34,31 @@ namespace ds {
 	class AbstractAction {
 
 		public:
-			AbstractAction(ChannelArray* array, const Rect& boundingRect, const char* name) : _array(array), m_BoundingRect(boundingRect) , _name(name) {
+			AbstractAction(ChannelArray* array, const Rect& boundingRect, const char* name) : _array(array), m_BoundingRect(boundingRect) , _name(name) , _tweenMode(TM_EAGER) , _handles(0) , _wheel(0) , _timerOwner(TO_ACTION) , _timerType(0) , _sortKeys(0) , _sortCapacity(0) , _budget(0) , _dirty(0) , _steps(1.0f) , _lodFrame(0) , _sliceStart(0) , _numAttachments(0) {
 				_hash = StaticHash(name);
 				//m_BoundingRect = Rect(0, 0, 1024, 768);
 			}
-			virtual ~AbstractAction() {}
+			virtual ~AbstractAction();
 			virtual void update(float dt,ActionEventBuffer& buffer) = 0;
+			// actions without dependencies between rows can be updated in chunks
+			virtual bool supportsChunks() const {
+				return false;
+			}
+			virtual void updateChunk(float dt, ActionEventBuffer& buffer, uint32_t start, uint32_t end) {}
+			// the channels read and written by update - used to run actions in parallel
+			virtual uint32_t getReadChannels() const {
+				return ALL_CHANNELS;
+			}
+			virtual uint32_t getWriteChannels() const {
+				return ALL_CHANNELS;
+			}
+			// the scheduler reserves the event buffers of a task by this
+			virtual int getMaxEventsPerRow() const {
+				return 1;
+			}
+			uint32_t getNumRows() const {
+				return _buffer.size;
+			}
 			void removeByIndex(int i);
 			void setBoundingRect(const Rect& r);
 			virtual void allocate(int sz) = 0;
@@ -40,16 +74,99 @@ namespace ds {
 			}
 			virtual void saveReport(const ReportWriter& writer) = 0;
 			virtual void attach(ID id, ActionSettings* settings) {}
+			// writes the current values of all rows into the channels (only used by tweening actions)
+			virtual void materialize() {}
+			void setTweenMode(TweenMode mode) {
+				_tweenMode = mode;
+			}
+			// called by the world when a timer scheduled by this action has expired
+			virtual void onTimer(const TimerEvent& e, ActionEventBuffer& buffer) {}
+			void setTimerWheel(TimerWheel* wheel, int owner, int type) {
+				_wheel = wheel;
+				_timerOwner = owner;
+				_timerType = type;
+			}
+			// sorts all rows by the dense index of the entity
+			void sortRows();
+			// updates, timers and materialize mark the rows they have written in it
+			void setDirtyChannels(DirtyChannels* dirty) {
+				_dirty = dirty;
+			}
+			// marks the write channels of the rows [start, end) as changed
+			void markRows(uint32_t start, uint32_t end) const;
+			// false if update does not write the channels (lazy tweens)
+			virtual bool writesOnUpdate() const {
+				return true;
+			}
+			// updates the rows of chunked actions at the rate of their LOD band
+			void updateLOD(float dt, ActionEventBuffer& buffer, const ActionLOD& lod);
+			// maximum number of rows a chunked action updates per frame - 0 = unlimited
+			void setBudget(uint32_t rows) {
+				_budget = rows;
+			}
+			uint32_t getBudget() const {
+				return _budget;
+			}
+			// sets the bit of the entity of every row
+			void markActive(uint32_t* bits) const;
+			// serial number of the last attach of the entity - 0 if it was never attached
+			uint32_t getAttachment(ID id) const {
+				uint32_t index = id & INDEX_MASK;
+				return index < _attachments.size() ? _attachments[index] : 0;
+			}
 		protected:
 			int create(ID id);
 			int find(ID id);
 			ID swap(int index);
+			TimerHandle schedule(ID id, int index, float ttl);
+			void cancel(TimerHandle handle);
+			int findTimer(const TimerEvent& e);
+			// marks the write channels of the entity as changed
+			void markRow(ID id) const {
+				if (_dirty != 0) {
+					_dirty->mark(id, getWriteChannels());
+				}
+			}
+			// prefetches the channel row of the entity at the given row
+			void prefetch(int index, int channel) const {
+#ifdef DS_ACTION_PREFETCH
+				if ((uint32_t)index < _buffer.size) {
+					const char* p = (const char*)_array->get_ptr(channel) + _array->row(_ids[index], channel) * _array->_sizes[channel];
+					_mm_prefetch(p, _MM_HINT_T0);
+				}
+#endif
+			}
 			Rect m_BoundingRect;
 			BlockArray _buffer;
 			ID* _ids;
 			int* _channels;
 			ChannelArray* _array;
+			TweenMode _tweenMode;
+			// optional column of timer handles - set by actions using timers
+			TimerHandle* _handles;
+			TimerWheel* _wheel;
+			DirtyChannels* _dirty;
+			// number of frames the current updateChunk stands for
+			float _steps;
 		private:
+			void reserveSortKeys(uint32_t num);
+			void applyOrder(const uint32_t* rows);
+			void setUpdated(ID id, uint32_t frame);
+			int _timerOwner;
+			int _timerType;
+			uint64_t* _sortKeys;
+			uint32_t _sortCapacity;
+			RadixSort _sorter;
+			uint32_t _budget;
+			// entity index -> LOD frame of the last sliced update
+			Array<uint32_t> _updated;
+			// frame of the last sliced update and the frame all rows 
+			// were updated at before slicing started
+			uint32_t _lodFrame;
+			uint32_t _sliceStart;
+			// entity index -> serial number of the last attach
+			Array<uint32_t> _attachments;
+			uint32_t _numAttachments;
 			const char* _name;
 			StaticHash _hash;
 		};
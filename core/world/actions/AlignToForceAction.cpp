@@ -43,11 +43,11 @@ namespace ds {
 			for (int i = 0; i < _buffer.size; ++i) {				
 				v3 force = _array->get<v3>(_ids[i], WEC_FORCE);
 				float angle = math::calculateRotation(force.xy());
-				_array->set<v3>(_ids[i], WEC_ROTATION, v3(angle));
+				channels::setRotation(_array, _ids[i], v3(angle));
 				if (_ttl[i] > 0.0f) {
 					_timers[i] += dt;
 					if (_timers[i] >= _ttl[i]) {
-						int t = _array->get<int>(_ids[i], WEC_TYPE);
+						int t = channels::getType(_array, _ids[i]);
 						buffer.add(_ids[i], AT_ALIGN_TO_FORCE, t);
 						removeByIndex(i);
 					}
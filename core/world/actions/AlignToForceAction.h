@@ -32,6 +32,12 @@ namespace ds {
 		ActionType getActionType() const {
 			return AT_ALIGN_TO_FORCE;
 		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_FORCE) | WEC_MASK(WEC_TYPE);
+		}
+		uint32_t getWriteChannels() const {
+			return WEC_MASK(WEC_ROTATION);
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		void allocate(int sz);
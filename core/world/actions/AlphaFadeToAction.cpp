@@ -6,9 +6,9 @@ namespace ds {
 	// -------------------------------------------------------
 	// 
 	// -------------------------------------------------------
-	AlphaFadeToAction::AlphaFadeToAction(ChannelArray* array, const Rect& boundingRect) : AbstractAction(array, boundingRect, "alpha_fade") {
-		int sizes[] = { sizeof(ID), sizeof(float), sizeof(float),sizeof(float),sizeof(float)};
-		_buffer.init(sizes, 5);
+	AlphaFadeToAction::AlphaFadeToAction(ChannelArray* array, const Rect& boundingRect) : AbstractAction(array, boundingRect, "alpha_fade") , _now(0.0f) {
+		int sizes[] = { sizeof(ID), sizeof(float), sizeof(float),sizeof(float),sizeof(float),sizeof(TimerHandle)};
+		_buffer.init(sizes, 6);
 	}
 
 	// -------------------------------------------------------
@@ -21,41 +21,70 @@ namespace ds {
 			_ids = (ID*)_buffer.get_ptr(0);
 			_startAlphas = (float*)_buffer.get_ptr(1);
 			_endAlphas = (float*)_buffer.get_ptr(2);
-			_timers = (float*)_buffer.get_ptr(3);
+			_startTimes = (float*)_buffer.get_ptr(3);
 			_ttl = (float*)_buffer.get_ptr(4);
+			_handles = (TimerHandle*)_buffer.get_ptr(5);
 		}
 	}
 	// -------------------------------------------------------
 	// 
 	// -------------------------------------------------------
 	void AlphaFadeToAction::attach(ID id,float startAlpha,float endAlpha,float ttl) {
-		int idx = create(id);
+		int idx = find(id);
+		if (idx != -1) {
+			cancel(_handles[idx]);
+		}
+		idx = create(id);
 		_ids[idx] = id;
 		_startAlphas[idx] = startAlpha;
 		_endAlphas[idx] = endAlpha;
-		_timers[idx] = 0.0f;
+		_startTimes[idx] = _now;
 		_ttl[idx] = ttl;
+		_handles[idx] = schedule(id, idx, ttl);
 	}
 
 	// -------------------------------------------------------
-	// 
+	// update - advances the clock and writes the values in
+	// TM_EAGER mode
 	// -------------------------------------------------------
 	void AlphaFadeToAction::update(float dt,ActionEventBuffer& buffer) {	
-		if ( _buffer.size > 0 ) {				
-			// move
-			for ( int i = 0; i < _buffer.size; ++i ) {
-				float norm = _timers[i] / _ttl[i];
-				Color c = _array->get<Color>(_ids[i], WEC_COLOR);
-				c.a = _startAlphas[i] * (1.0f - norm) + _endAlphas[i] * norm;
-				_array->set(_ids[i],WEC_COLOR, c);
-				_timers[i] += dt;
-				if ( _timers[i] >= _ttl[i] ) {
-					c.a = _endAlphas[i];
-					_array->set(_ids[i], WEC_COLOR, c);
-					removeByIndex(i);
-				}
+		if ( _buffer.size > 0 ) {
+			_now += dt;
+			if (_tweenMode == TM_EAGER) {
+				materialize();
 			}
 		}
+		else {
+			_now = 0.0f;
+		}
+	}
+
+	// -------------------------------------------------------
+	// materialize - evaluate all rows at the current time
+	// -------------------------------------------------------
+	void AlphaFadeToAction::materialize() {
+		for (uint32_t i = 0; i < _buffer.size; ++i) {
+			float norm = math::norm(_now - _startTimes[i], _ttl[i]);
+			Color c = channels::getColor(_array, _ids[i]);
+			c.a = _startAlphas[i] * (1.0f - norm) + _endAlphas[i] * norm;
+			channels::setColor(_array, _ids[i], c);
+		}
+	}
+
+	// -------------------------------------------------------
+	// on timer - ttl has expired
+	// -------------------------------------------------------
+	void AlphaFadeToAction::onTimer(const TimerEvent& e, ActionEventBuffer& buffer) {
+		int i = findTimer(e);
+		if (i == -1) {
+			return;
+		}
+		Color c = channels::getColor(_array, e.id);
+		c.a = _endAlphas[i];
+		channels::setColor(_array, e.id, c);
+		markRow(e.id);
+		buffer.add(e.id, AT_ALPHA_FADE_TO, channels::getType(_array, e.id));
+		removeByIndex(i);
 	}
 
 	void AlphaFadeToAction::saveReport(const ReportWriter& writer) {
@@ -69,7 +98,7 @@ namespace ds {
 				writer.addCell(_startAlphas[i]);
 				writer.addCell(_endAlphas[i]);
 				writer.addCell(_ttl[i]);
-				writer.addCell(_timers[i]);
+				writer.addCell(_now - _startTimes[i]);
 				writer.endRow();
 			}
 			writer.endTable();
@@ -11,16 +11,28 @@ namespace ds {
 		~AlphaFadeToAction();
 		void attach(ID id,float startAlpha,float endAlpha,float ttl);
 		void update(float dt, ActionEventBuffer& buffer);
+		void materialize();
+		void onTimer(const TimerEvent& e, ActionEventBuffer& buffer);
 		ActionType getActionType() const {
 			return AT_ALPHA_FADE_TO;
 		}
+		bool writesOnUpdate() const {
+			return _tweenMode == TM_EAGER;
+		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_COLOR);
+		}
+		uint32_t getWriteChannels() const {
+			return WEC_MASK(WEC_COLOR);
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		void allocate(int sz);
 		float* _startAlphas;
 		float* _endAlphas;
-		float* _timers;
+		float* _startTimes;
 		float* _ttl;
+		float _now;
 	};
 
 
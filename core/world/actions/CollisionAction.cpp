@@ -32,7 +32,7 @@ namespace ds {
 	// -------------------------------------------------------
 	void CollisionAction::attach(ID id, ActionSettings* settings) {
 		CollisionActionSettings* s = (CollisionActionSettings*)settings;
-		const Texture& t = _array->get<Texture>(id, WEC_TEXTURE);
+		const Texture& t = channels::getTexture(_array, id);
 		v3 extent = v3(t.dim.x, t.dim.y, 0.0f);
 		attach(id, s->shapeType, extent);
 	}
@@ -93,13 +93,15 @@ namespace ds {
 			for (uint32_t i = 0; i < _buffer.size; ++i) {
 				if (!_attached[i]) {
 					_attached[i] = true;
-					buffer.add(_ids[i], AT_COLLIDER_ATTACHED, _array->get<int>(_ids[i], WEC_TYPE));
+					buffer.add(_ids[i], AT_COLLIDER_ATTACHED, channels::getType(_array, _ids[i]));
 				}
+				bool awake = _array->isAwake(_ids[i]);
 				for (uint32_t j = i + 1; j < _buffer.size; ++j) {
-					if (_ids[i] != _ids[j]) {
+					// two sleeping entities cannot start to overlap
+					if (_ids[i] != _ids[j] && (awake || _array->isAwake(_ids[j]))) {
 						Collision c;
-						c.firstType = _array->get<int>(_ids[i], WEC_TYPE);
-						c.secondType = _array->get<int>(_ids[j], WEC_TYPE);
+						c.firstType = channels::getType(_array, _ids[i]);
+						c.secondType = channels::getType(_array, _ids[j]);
 						if (isSupported(c.firstType, c.secondType)) {
 							if (intersects(i, j, &c)) {
 								//LOGC("physics") << "intersection between " << i << " ( id: " << _ids[i] << " type: " << c.firstType << ") and " << j << " ( id: " << _ids[j] << " type: " << c.secondType << ")";
@@ -174,7 +176,7 @@ namespace ds {
 				writer.startRow();
 				writer.addCell(_ids[i]);
 				writer.addCell(_types[i]);
-				writer.addCell(_array->get<int>(_ids[i], WEC_TYPE));
+				writer.addCell(channels::getType(_array, _ids[i]));
 				writer.addCell(_extents[i]);
 				writer.endRow();
 			}
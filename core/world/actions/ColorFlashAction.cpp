@@ -50,14 +50,16 @@ namespace ds {
 	void ColorFlashAction::update(float dt, ActionEventBuffer& buffer) {
 		if ( _buffer.size > 0 ) {				
 			for ( int i = 0; i < _buffer.size; ++i ) {
-				_array->set<Color>(_ids[i], WEC_COLOR,tweening::interpolate(tweening::easeSinus, _startColors[i], _endColors[i], _timers[i], _ttl[i]));
+				prefetch(i + ACTION_PREFETCH_DISTANCE, WEC_COLOR);
+				channels::setColor(_array, _ids[i], tweening::interpolate(tweening::easeSinus, _startColors[i], _endColors[i], _timers[i], _ttl[i]));
 				_timers[i] += dt;
 				if ( _timers[i] >= _ttl[i] ) {
 					if ( _modes[i] < 0 ) {
 						_timers[i] = 0.0f;
 					}
 					else if ( _modes[i] == 0 ) {
-						_array->set<Color>(_ids[i], WEC_COLOR, _endColors[i]);
+						channels::setColor(_array, _ids[i], _endColors[i]);
+						buffer.add(_ids[i], AT_COLOR_FLASH, channels::getType(_array, _ids[i]));
 						removeByIndex(i);
 					}
 					else {
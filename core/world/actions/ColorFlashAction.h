@@ -16,6 +16,12 @@ namespace ds {
 		ActionType getActionType() const {
 			return AT_COLOR_FLASH;
 		}
+		uint32_t getReadChannels() const {
+			return 0;
+		}
+		uint32_t getWriteChannels() const {
+			return WEC_MASK(WEC_COLOR);
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		void allocate(int sz);
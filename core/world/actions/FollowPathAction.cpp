@@ -0,0 +1,175 @@
+#include "FollowPathAction.h"
+#include "..\..\log\Log.h"
+#include "..\..\math\math.h"
+
+namespace ds {
+	// -------------------------------------------------------
+	// 
+	// -------------------------------------------------------
+	FollowPathAction::FollowPathAction(ChannelArray* array, const Rect& boundingRect, ActionType type, const char* name) : AbstractAction(array, boundingRect, name) , _now(0.0f) , _type(type) {
+		int sizes[] = { sizeof(ID), sizeof(Path*), sizeof(float), sizeof(float), sizeof(int), sizeof(bool), sizeof(TimerHandle) };
+		_buffer.init(sizes, 7);
+	}
+
+	void FollowPathAction::allocate(int sz) {
+		if (_buffer.resize(sz)) {
+			_ids = (ID*)_buffer.get_ptr(0);
+			_paths = (Path**)_buffer.get_ptr(1);
+			_startTimes = (float*)_buffer.get_ptr(2);
+			_ttl = (float*)_buffer.get_ptr(3);
+			_modes = (int*)_buffer.get_ptr(4);
+			_rotate = (bool*)_buffer.get_ptr(5);
+			_handles = (TimerHandle*)_buffer.get_ptr(6);
+		}
+	}
+
+	void FollowPathAction::attach(ID id, ActionSettings* settings) {
+		FollowPathSettings* s = (FollowPathSettings*)settings;
+		float ttl = math::randomRange(s->ttl, s->ttlVariance);
+		attach(id, s->path, ttl, s->mode, s->rotate);
+	}
+
+	// -------------------------------------------------------
+	// 
+	// -------------------------------------------------------
+	void FollowPathAction::attach(ID id, Path* path, float ttl, int mode, bool rotate) {
+		assert(path != 0);
+		int idx = find(id);
+		if (idx != -1) {
+			cancel(_handles[idx]);
+		}
+		idx = create(id);
+		_ids[idx] = id;
+		_paths[idx] = path;
+		_startTimes[idx] = _now;
+		_ttl[idx] = ttl;
+		_modes[idx] = mode;
+		_rotate[idx] = rotate;
+		if (mode > 0) {
+			--_modes[idx];
+		}
+		_handles[idx] = schedule(id, idx, ttl);
+		v2 p;
+		path->approx(0.0f, &p);
+		_array->set<v3>(id, WEC_POSITION, v3(p));
+	}
+
+	// -------------------------------------------------------
+	// update - advances the clock and writes the positions
+	// in TM_EAGER mode
+	// -------------------------------------------------------
+	void FollowPathAction::update(float dt, ActionEventBuffer& buffer) {
+		if (_buffer.size > 0) {
+			_now += dt;
+			if (_tweenMode == TM_EAGER) {
+				materialize();
+			}
+		}
+		else {
+			_now = 0.0f;
+		}
+	}
+
+	// -------------------------------------------------------
+	// materialize - sorts the rows by path and samples every
+	// run of rows sharing the same path in one batch
+	// -------------------------------------------------------
+	void FollowPathAction::materialize() {
+		if (_buffer.size == 0) {
+			return;
+		}
+		_keys.clear();
+		for (uint32_t i = 0; i < _buffer.size; ++i) {
+			_keys.push_back((uint64_t)(uintptr_t)_paths[i]);
+		}
+		const uint32_t* order = _sorter.sort(_keys.data(), _buffer.size);
+		_rows.clear();
+		_params.clear();
+		_positions.clear();
+		_tangents.clear();
+		for (uint32_t i = 0; i < _buffer.size; ++i) {
+			uint32_t row = order[i];
+			_rows.push_back(row);
+			_params.push_back(math::clamp(math::norm(_now - _startTimes[row], _ttl[row])));
+			_positions.push_back(v2(0.0f, 0.0f));
+			_tangents.push_back(v2(0.0f, 0.0f));
+		}
+		uint32_t start = 0;
+		for (uint32_t i = 1; i <= _rows.size(); ++i) {
+			if (i == _rows.size() || _paths[_rows[i]] != _paths[_rows[start]]) {
+				sample(start, i);
+				start = i;
+			}
+		}
+	}
+
+	// -------------------------------------------------------
+	// sample the sorted rows [start, end) sharing one path
+	// -------------------------------------------------------
+	void FollowPathAction::sample(uint32_t start, uint32_t end) {
+		Path* path = _paths[_rows[start]];
+		int num = end - start;
+		bool rotate = false;
+		for (uint32_t i = start; i < end; ++i) {
+			rotate |= _rotate[_rows[i]];
+		}
+		path->sampleMany(&_params[start], &_positions[start], num);
+		if (rotate) {
+			path->tangentMany(&_params[start], &_tangents[start], num);
+		}
+		for (uint32_t i = start; i < end; ++i) {
+			int row = _rows[i];
+			_array->set<v3>(_ids[row], WEC_POSITION, v3(_positions[i]));
+			if (_rotate[row]) {
+				channels::setRotation(_array, _ids[row], v3(math::calculateRotation(_tangents[i])));
+			}
+		}
+	}
+
+	// -------------------------------------------------------
+	// on timer - restart or finish the row
+	// -------------------------------------------------------
+	void FollowPathAction::onTimer(const TimerEvent& e, ActionEventBuffer& buffer) {
+		int i = findTimer(e);
+		if (i == -1) {
+			return;
+		}
+		if (_modes[i] == 0) {
+			v2 p;
+			_paths[i]->approx(1.0f, &p);
+			_array->set<v3>(e.id, WEC_POSITION, v3(p));
+			markRow(e.id);
+			buffer.add(e.id, _type, channels::getType(_array, e.id));
+			removeByIndex(i);
+		}
+		else {
+			if (_modes[i] > 0) {
+				--_modes[i];
+			}
+			_startTimes[i] = _now;
+			_handles[i] = schedule(e.id, i, _ttl[i]);
+		}
+	}
+
+	// -------------------------------------------------------
+	// 
+	// -------------------------------------------------------
+	void FollowPathAction::saveReport(const ReportWriter& writer) {
+		if (_buffer.size > 0) {
+			writer.addSubHeader(getName());
+			const char* HEADERS[] = { "Index", "ID", "TTL", "Timer", "Mode" };
+			writer.startTable(HEADERS, 5);
+			for (uint32_t i = 0; i < _buffer.size; ++i) {
+				writer.startRow();
+				writer.addCell(i);
+				writer.addCell(_ids[i]);
+				writer.addCell(_ttl[i]);
+				writer.addCell(_now - _startTimes[i]);
+				writer.addCell(_modes[i]);
+				writer.endRow();
+			}
+			writer.endTable();
+		}
+	}
+
+}
\ No newline at end of file
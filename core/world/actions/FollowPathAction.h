@@ -0,0 +1,79 @@
+#pragma once
+#include "..\World.h"
+#include "AbstractAction.h"
+#include "..\..\math\CubicBezierPath.h"
+
+namespace ds {
+
+	struct FollowPathSettings : public ActionSettings {
+
+		Path* path;
+		int mode;
+		bool rotate;
+
+		FollowPathSettings() : path(0), mode(0), rotate(true) {
+			type = AT_FOLLOW_PATH;
+			ttl = 0.0f;
+			ttlVariance = 0.0f;
+		}
+		FollowPathSettings(Path* p, float t, int m = 0, bool r = true) : path(p), mode(m), rotate(r) {
+			type = AT_FOLLOW_PATH;
+			ttl = t;
+			ttlVariance = 0.0f;
+		}
+
+	};
+
+	// -------------------------------------------------------
+	// FollowPathAction
+	//
+	// Moves entities along a path within ttl seconds. The
+	// same class is used for AT_FOLLOW_PATH, AT_FOLLOW_CURVE
+	// and AT_FOLLOW_STRAIGHT_PATH. The rows are sorted by
+	// path so all entities sharing the same path are sampled
+	// in one batch. 
+	// mode: 0 = once / > 0 number of repeats / < 0 loop
+	// -------------------------------------------------------
+	class FollowPathAction : public AbstractAction {
+
+	public:
+		FollowPathAction(ChannelArray* array, const Rect& boundingRect, ActionType type, const char* name);
+		virtual ~FollowPathAction() {}
+		void attach(ID id, ActionSettings* settings);
+		void attach(ID id, Path* path, float ttl, int mode = 0, bool rotate = true);
+		void update(float dt, ActionEventBuffer& buffer);
+		void materialize();
+		void onTimer(const TimerEvent& e, ActionEventBuffer& buffer);
+		ActionType getActionType() const {
+			return _type;
+		}
+		bool writesOnUpdate() const {
+			return _tweenMode == TM_EAGER;
+		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_TYPE);
+		}
+		uint32_t getWriteChannels() const {
+			return WEC_MASK(WEC_POSITION) | WEC_MASK(WEC_ROTATION);
+		}
+		void saveReport(const ReportWriter& writer);
+	private:
+		void allocate(int sz);
+		void sample(uint32_t start, uint32_t end);
+		Path** _paths;
+		float* _startTimes;
+		float* _ttl;
+		int* _modes;
+		bool* _rotate;
+		float _now;
+		ActionType _type;
+		// scratch buffers for the batched evaluation
+		RadixSort _sorter;
+		Array<uint64_t> _keys;
+		Array<int> _rows;
+		Array<float> _params;
+		Array<v2> _positions;
+		Array<v2> _tangents;
+	};
+
+}
\ No newline at end of file
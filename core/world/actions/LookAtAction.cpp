@@ -46,9 +46,9 @@ namespace ds {
 		if (ttl == 0.0f) {
 			v3 p = _array->get<v3>(id, WEC_POSITION);
 			v3 t = _array->get<v3>(target, WEC_POSITION);
-			v3 r = _array->get<v3>(id, WEC_ROTATION);
+			v3 r = channels::getRotation(_array, id);
 			r.x = math::getAngle(p.xy(), t.xy());
-			_array->set<v3>(id, WEC_ROTATION, r);
+			channels::setRotation(_array, id, r);
 		}
 		else {
 			int idx = create(id);
@@ -67,13 +67,13 @@ namespace ds {
 			for (uint32_t i = 0; i < _buffer.size; ++i) {
 				v3 p = _array->get<v3>(_ids[i], WEC_POSITION);
 				v3 t = _array->get<v3>(_targets[i],WEC_POSITION);
-				v3 r = _array->get<v3>(_ids[i], WEC_ROTATION);
+				v3 r = channels::getRotation(_array, _ids[i]);
 				r.x = math::getAngle(p.xy(), t.xy());
-				_array->set<v3>(_ids[i], WEC_ROTATION, r);
+				channels::setRotation(_array, _ids[i], r);
 				if (_ttl[i] > 0.0f) {
 					_timers[i] += dt;
 					if (_timers[i] >= _ttl[i]) {
-						int t = _array->get<int>(_ids[i], WEC_TYPE);
+						int t = channels::getType(_array, _ids[i]);
 						buffer.add(_ids[i], AT_LOOK_AT, t);
 						removeByIndex(i);
 					}
@@ -26,6 +26,12 @@ namespace ds {
 		ActionType getActionType() const {
 			return AT_LOOK_AT;
 		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_POSITION) | WEC_MASK(WEC_ROTATION) | WEC_MASK(WEC_TYPE) | WEC_MASK(WEC_HASH);
+		}
+		uint32_t getWriteChannels() const {
+			return WEC_MASK(WEC_ROTATION);
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		void allocate(int sz);
@@ -1,23 +1,26 @@
 #include "MoveByAction.h"
 #include "..\..\log\Log.h"
 #include "..\..\math\math.h"
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DS_MOVE_BY_SSE
+#include <emmintrin.h>
+#endif
 
 namespace ds {
 	// -------------------------------------------------------
 	// 
 	// -------------------------------------------------------
 	MoveByAction::MoveByAction(ChannelArray* array, const Rect& boundingRect) : AbstractAction(array, boundingRect, "move_by") {
-		int sizes[] = { sizeof(ID), sizeof(v3), sizeof(float), sizeof(float), sizeof(bool) };
-		_buffer.init(sizes, 5);
+		int sizes[] = { sizeof(ID), sizeof(v3), sizeof(TimerHandle), sizeof(bool) };
+		_buffer.init(sizes, 4);
 	}
 
 	void MoveByAction::allocate(int sz) {
 		if (_buffer.resize(sz)) {
 			_ids = (ID*)_buffer.get_ptr(0);
 			_velocities = (v3*)_buffer.get_ptr(1);
-			_timers = (float*)_buffer.get_ptr(2);
-			_ttl = (float*)_buffer.get_ptr(3);
-			_bounce = (bool*)_buffer.get_ptr(4);
+			_handles = (TimerHandle*)_buffer.get_ptr(2);
+			_bounce = (bool*)_buffer.get_ptr(3);
 		}
 	}
 
@@ -25,7 +28,7 @@ namespace ds {
 		MoveBySettings* s = (MoveBySettings*)settings;
 		v3 vel = s->velocity;
 		if (s->radialVelocity != 0.0f) {
-			v3 angle = _array->get<v3>(id, WEC_ROTATION);
+			v3 angle = channels::getRotation(_array, id);
 			vel = v3(math::getRadialVelocity(angle.x, s->radialVelocity));
 		}
 		attach(id, vel, s->ttl, s->bounce);
@@ -35,18 +38,24 @@ namespace ds {
 	// 
 	// -------------------------------------------------------
 	void MoveByAction::attach(ID id,const v3& velocity,float ttl, bool bounce) {		
-		int idx = create(id);
+		int idx = find(id);
+		if (idx != -1) {
+			cancel(_handles[idx]);
+		}
+		idx = create(id);
 		_ids[idx] = id;
 		_velocities[idx] = velocity;
 		_bounce[idx] = bounce;
-		_timers[idx] = 0.0f;
-		_ttl[idx] = ttl;
+		_handles[idx] = INVALID_TIMER;
+		if (ttl > 0.0f) {
+			_handles[idx] = schedule(id, idx, ttl);
+		}
 		rotateTo(idx);
 	}
 
 	void MoveByAction::rotateTo(int index) {
 		float angle = math::calculateRotation(_velocities[index].xy());
-		_array->set<v3>(_ids[index],WEC_ROTATION,v3(angle));
+		channels::setRotation(_array, _ids[index], v3(angle));
 	}
 
 	int MoveByAction::isOutOfBounds(const v3& pos, const v3& v, const v2& dim) {
@@ -76,7 +85,7 @@ namespace ds {
 					_velocities[i].x *= -1.0f;
 				}
 				float angle = math::calculateRotation(_velocities[i].xy());
-				_array->set<v3>(sid,WEC_ROTATION,v3(angle));
+				channels::setRotation(_array, sid, v3(angle));
 				v3 p = _array->get<v3>(sid,WEC_FORCE);
 				p += _velocities[i] * dt;
 				_array->set<v3>(sid, WEC_FORCE, p);
@@ -88,43 +97,118 @@ namespace ds {
 	// 
 	// -------------------------------------------------------
 	void MoveByAction::update(float dt,ActionEventBuffer& buffer) {	
+		updateChunk(dt, buffer, 0, _buffer.size);
+	}
+
+	// -------------------------------------------------------
+	// update chunk - every row only touches its own entity.
+	// Blocks of four rows are integrated and checked against
+	// the bounding rect with SSE. Only blocks with a row
+	// leaving the rect fall back to the scalar path.
+	// -------------------------------------------------------
+	void MoveByAction::updateChunk(float dt, ActionEventBuffer& buffer, uint32_t start, uint32_t end) {
 		if (_buffer.size > 0) {
-			for (int i = 0; i < _buffer.size; ++i) {
-				v3 p = _array->get<v3>(_ids[i],WEC_FORCE);
-				p += _velocities[i] * dt;
-				v3 pos = _array->get<v3>(_ids[i], WEC_POSITION);
-				pos += p;				
-				const Texture& t = _array->get<Texture>(_ids[i], WEC_TEXTURE);
-				int d = isOutOfBounds(pos, _velocities[i], t.dim * 0.5f);
-				if (d != 0) {
-					if (_bounce[i]) {										
-						if ( (d & 4) == 4 || (d & 8) == 8) {
-							_velocities[i].y *= -1.0f;
-						}
-						if ((d & 1) == 1 || (d & 2) == 2) {
-							_velocities[i].x *= -1.0f;
-						}
-						int t = _array->get<int>(_ids[i], WEC_TYPE);
-						buffer.add(_ids[i], AT_BOUNCE, t, &_velocities[i], sizeof(v3));
-						rotateTo(i);
-						p += _velocities[i] * dt;// *1.5f;
-					}
-					else {
-						int t = _array->get<int>(_ids[i], WEC_TYPE);
-						buffer.add(_ids[i], AT_MOVE_BY, t);
+			uint32_t i = start;
+#ifdef DS_MOVE_BY_SSE
+			const v3* forces = (const v3*)_array->get_ptr(WEC_FORCE);
+			const v3* positions = (const v3*)_array->get_ptr(WEC_POSITION);
+			const int* sparse = _array->_sparse;
+			__m128 vdt = _mm_set1_ps(dt);
+			__m128 half = _mm_set1_ps(0.5f);
+			__m128 zero = _mm_setzero_ps();
+			__m128 left = _mm_set1_ps(m_BoundingRect.left);
+			__m128 right = _mm_set1_ps(m_BoundingRect.right);
+			__m128 top = _mm_set1_ps(m_BoundingRect.top);
+			__m128 bottom = _mm_set1_ps(m_BoundingRect.bottom);
+			for (; i + 4 <= end; i += 4) {
+				prefetch(i + ACTION_PREFETCH_DISTANCE, WEC_FORCE);
+				prefetch(i + ACTION_PREFETCH_DISTANCE, WEC_POSITION);
+				int r0 = sparse[_ids[i] & INDEX_MASK];
+				int r1 = sparse[_ids[i + 1] & INDEX_MASK];
+				int r2 = sparse[_ids[i + 2] & INDEX_MASK];
+				int r3 = sparse[_ids[i + 3] & INDEX_MASK];
+				const v3* v = _velocities + i;
+				__m128 vx = _mm_set_ps(v[3].x, v[2].x, v[1].x, v[0].x);
+				__m128 vy = _mm_set_ps(v[3].y, v[2].y, v[1].y, v[0].y);
+				__m128 px = _mm_add_ps(_mm_set_ps(forces[r3].x, forces[r2].x, forces[r1].x, forces[r0].x), _mm_mul_ps(vx, vdt));
+				__m128 py = _mm_add_ps(_mm_set_ps(forces[r3].y, forces[r2].y, forces[r1].y, forces[r0].y), _mm_mul_ps(vy, vdt));
+				__m128 x = _mm_add_ps(_mm_set_ps(positions[r3].x, positions[r2].x, positions[r1].x, positions[r0].x), px);
+				__m128 y = _mm_add_ps(_mm_set_ps(positions[r3].y, positions[r2].y, positions[r1].y, positions[r0].y), py);
+				const Texture& t0 = channels::textureAt(_array, r0);
+				const Texture& t1 = channels::textureAt(_array, r1);
+				const Texture& t2 = channels::textureAt(_array, r2);
+				const Texture& t3 = channels::textureAt(_array, r3);
+				__m128 dx = _mm_mul_ps(_mm_set_ps(t3.dim.x, t2.dim.x, t1.dim.x, t0.dim.x), half);
+				__m128 dy = _mm_mul_ps(_mm_set_ps(t3.dim.y, t2.dim.y, t1.dim.y, t0.dim.y), half);
+				__m128 out = _mm_and_ps(_mm_cmpgt_ps(vx, zero), _mm_cmpgt_ps(x, _mm_sub_ps(right, dx)));
+				out = _mm_or_ps(out, _mm_and_ps(_mm_cmplt_ps(vx, zero), _mm_cmplt_ps(x, _mm_add_ps(left, dx))));
+				out = _mm_or_ps(out, _mm_and_ps(_mm_cmpgt_ps(vy, zero), _mm_cmpgt_ps(y, _mm_sub_ps(bottom, dy))));
+				out = _mm_or_ps(out, _mm_and_ps(_mm_cmplt_ps(vy, zero), _mm_cmplt_ps(y, _mm_add_ps(top, dy))));
+				if (_mm_movemask_ps(out) != 0) {
+					for (uint32_t j = i; j < i + 4; ++j) {
+						updateRow(j, dt, buffer);
 					}
 				}
-				if (_ttl[i] > 0.0f) {
-					_timers[i] += dt;
-					if (_timers[i] >= _ttl[i]) {
-						int t = _array->get<int>(_ids[i], WEC_TYPE);
-						buffer.add(_ids[i], AT_MOVE_BY, t);
-						removeByIndex(i);
+				else {
+					float fx[4];
+					float fy[4];
+					_mm_storeu_ps(fx, px);
+					_mm_storeu_ps(fy, py);
+					int rows[] = { r0, r1, r2, r3 };
+					v3* f = (v3*)_array->get_ptr(WEC_FORCE);
+					for (int j = 0; j < 4; ++j) {
+						f[rows[j]] = v3(fx[j], fy[j], f[rows[j]].z + v[j].z * dt);
 					}
 				}
-				_array->set<v3>(_ids[i],WEC_FORCE, p);
 			}
+#endif
+			for (; i < end; ++i) {
+				prefetch(i + ACTION_PREFETCH_DISTANCE, WEC_FORCE);
+				prefetch(i + ACTION_PREFETCH_DISTANCE, WEC_POSITION);
+				updateRow(i, dt, buffer);
+			}
+		}
+	}
+
+	void MoveByAction::updateRow(uint32_t i, float dt, ActionEventBuffer& buffer) {
+		v3 p = _array->get<v3>(_ids[i],WEC_FORCE);
+		p += _velocities[i] * dt;
+		v3 pos = _array->get<v3>(_ids[i], WEC_POSITION);
+		pos += p;				
+		const Texture& t = channels::getTexture(_array, _ids[i]);
+		int d = isOutOfBounds(pos, _velocities[i], t.dim * 0.5f);
+		if (d != 0) {
+			if (_bounce[i]) {										
+				if ( (d & 4) == 4 || (d & 8) == 8) {
+					_velocities[i].y *= -1.0f;
+				}
+				if ((d & 1) == 1 || (d & 2) == 2) {
+					_velocities[i].x *= -1.0f;
+				}
+				int t = channels::getType(_array, _ids[i]);
+				buffer.add(_ids[i], AT_BOUNCE, t, &_velocities[i], sizeof(v3));
+				rotateTo(i);
+				p += _velocities[i] * dt;// *1.5f;
+			}
+			else {
+				int t = channels::getType(_array, _ids[i]);
+				buffer.add(_ids[i], AT_MOVE_BY, t);
+			}
+		}
+		_array->set<v3>(_ids[i],WEC_FORCE, p);
+	}
+
+	// -------------------------------------------------------
+	// on timer - ttl has expired
+	// -------------------------------------------------------
+	void MoveByAction::onTimer(const TimerEvent& e, ActionEventBuffer& buffer) {
+		int i = findTimer(e);
+		if (i == -1) {
+			return;
 		}
+		int t = channels::getType(_array, e.id);
+		buffer.add(e.id, AT_MOVE_BY, t);
+		removeByIndex(i);
 	}
 	
 	// -------------------------------------------------------
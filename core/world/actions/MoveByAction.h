@@ -41,19 +41,29 @@ namespace ds {
 		void attach(ID id, ActionSettings* settings);
 		void attach(ID id,const v3& velocity,float ttl = -1.0f, bool bounce = true);
 		void update(float dt,ActionEventBuffer& buffer);
+		bool supportsChunks() const {
+			return true;
+		}
+		void updateChunk(float dt, ActionEventBuffer& buffer, uint32_t start, uint32_t end);
 		void bounce(ID sid, BounceDirection direction,float dt);
+		void onTimer(const TimerEvent& e, ActionEventBuffer& buffer);
 		ActionType getActionType() const {
 			return AT_MOVE_BY;
 		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_POSITION) | WEC_MASK(WEC_ROTATION) | WEC_MASK(WEC_TEXTURE) | WEC_MASK(WEC_TYPE) | WEC_MASK(WEC_FORCE);
+		}
+		uint32_t getWriteChannels() const {
+			return WEC_MASK(WEC_ROTATION) | WEC_MASK(WEC_FORCE);
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		void allocate(int sz);
 		void rotateTo(int index);
 		int isOutOfBounds(const v3& pos, const v3& v,const v2& dim);
+		void updateRow(uint32_t i, float dt, ActionEventBuffer& buffer);
 
 		v3* _velocities;
-		float* _timers;
-		float* _ttl;
 		bool* _bounce;
 	};
 
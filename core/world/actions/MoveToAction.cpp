@@ -6,9 +6,9 @@ namespace ds {
 	// -------------------------------------------------------
 	// 
 	// -------------------------------------------------------
-	MoveToAction::MoveToAction(ChannelArray* array, const Rect& boundingRect) : AbstractAction(array, boundingRect, "move_to") {
-		int sizes[] = { sizeof(ID), sizeof(v3), sizeof(v3), sizeof(tweening::TweeningType) , sizeof(float), sizeof(float) };
-		_buffer.init(sizes, 6);
+	MoveToAction::MoveToAction(ChannelArray* array, const Rect& boundingRect) : AbstractAction(array, boundingRect, "move_to") , _now(0.0f) {
+		int sizes[] = { sizeof(ID), sizeof(v3), sizeof(v3), sizeof(tweening::TweeningType) , sizeof(float), sizeof(float), sizeof(TimerHandle) };
+		_buffer.init(sizes, 7);
 	}
 
 	void MoveToAction::allocate(int sz) {
@@ -17,8 +17,9 @@ namespace ds {
 			_start = (v3*)_buffer.get_ptr(1);
 			_end = (v3*)_buffer.get_ptr(2);
 			_tweeningTypes = (tweening::TweeningType*)_buffer.get_ptr(3);
-			_timers = (float*)_buffer.get_ptr(4);
+			_startTimes = (float*)_buffer.get_ptr(4);
 			_ttl = (float*)_buffer.get_ptr(5);
+			_handles = (TimerHandle*)_buffer.get_ptr(6);
 		}
 	}
 
@@ -30,39 +31,73 @@ namespace ds {
 	// 
 	// -------------------------------------------------------
 	void MoveToAction::attach(ID id, const v3& start, const v3& end, float ttl, const tweening::TweeningType& tweeningType) {
-		int idx = create(id);
+		int idx = find(id);
+		if (idx != -1) {
+			cancel(_handles[idx]);
+		}
+		idx = create(id);
 		_ids[idx] = id;
 		_start[idx] = start;
 		_end[idx] = end;
 		_tweeningTypes[idx] = tweeningType;
-		_timers[idx] = 0.0f;
+		_startTimes[idx] = _now;
 		_ttl[idx] = ttl;
+		_handles[idx] = INVALID_TIMER;
+		if (ttl > 0.0f) {
+			_handles[idx] = schedule(id, idx, ttl);
+		}
+		_array->set<v3>(id, WEC_POSITION, start);
 		//rotateTo(idx);
 	}
 
 	void MoveToAction::rotateTo(int index) {
 		float angle = math::getAngle(_end[index].xy(), _start[index].xy());
-		_array->set<v3>(_ids[index],WEC_ROTATION,v3(angle));
+		channels::setRotation(_array, _ids[index], v3(angle));
 	}
 	
 	// -------------------------------------------------------
-	// 
+	// update - only advances the clock. The positions are 
+	// only written in TM_EAGER mode and finished rows are 
+	// handled by the timer wheel.
 	// -------------------------------------------------------
 	void MoveToAction::update(float dt,ActionEventBuffer& buffer) {
 		if (_buffer.size > 0) {
-			for (int i = 0; i < _buffer.size; ++i) {
-				_array->set<v3>(_ids[i], WEC_POSITION, tweening::interpolate(_tweeningTypes[i], _start[i], _end[i], _timers[i], _ttl[i]));
-				if (_ttl[i] > 0.0f) {
-					_timers[i] += dt;
-					if (_timers[i] >= _ttl[i]) {
-						_array->set<v3>(_ids[i], WEC_POSITION, _end[i]);
-						int t = _array->get<int>(_ids[i], WEC_TYPE);
-						buffer.add(_ids[i], AT_MOVE_TO, t);
-						removeByIndex(i);
-					}
-				}
+			_now += dt;
+			if (_tweenMode == TM_EAGER) {
+				materialize();
 			}
 		}
+		else {
+			_now = 0.0f;
+		}
+	}
+
+	// -------------------------------------------------------
+	// materialize - evaluate all rows at the current time
+	// -------------------------------------------------------
+	void MoveToAction::materialize() {
+		for (uint32_t i = 0; i < _buffer.size; ++i) {
+			float elapsed = 0.0f;
+			if (_ttl[i] > 0.0f) {
+				elapsed = math::clamp(_now - _startTimes[i], 0.0f, _ttl[i]);
+			}
+			_array->set<v3>(_ids[i], WEC_POSITION, tweening::interpolate(_tweeningTypes[i], _start[i], _end[i], elapsed, _ttl[i]));
+		}
+	}
+
+	// -------------------------------------------------------
+	// on timer - ttl has expired
+	// -------------------------------------------------------
+	void MoveToAction::onTimer(const TimerEvent& e, ActionEventBuffer& buffer) {
+		int i = findTimer(e);
+		if (i == -1) {
+			return;
+		}
+		_array->set<v3>(e.id, WEC_POSITION, _end[i]);
+		markRow(e.id);
+		int t = channels::getType(_array, e.id);
+		buffer.add(e.id, AT_MOVE_TO, t);
+		removeByIndex(i);
 	}
 	
 	// -------------------------------------------------------
@@ -71,14 +106,16 @@ namespace ds {
 	void MoveToAction::saveReport(const ReportWriter& writer) {
 		if (_buffer.size > 0) {
 			writer.addSubHeader("MoveToAction");
-			const char* HEADERS[] = { "Index", "ID", "Start", "End"};
-			writer.startTable(HEADERS, 4);
+			const char* HEADERS[] = { "Index", "ID", "Start", "End", "TTL", "Timer"};
+			writer.startTable(HEADERS, 6);
 			for (uint32_t i = 0; i < _buffer.size; ++i) {
 				writer.startRow();
 				writer.addCell(i);
 				writer.addCell(_ids[i]);
 				writer.addCell(_start[i]);
 				writer.addCell(_end[i]);
+				writer.addCell(_ttl[i]);
+				writer.addCell(_now - _startTimes[i]);
 				writer.endRow();
 			}
 			writer.endTable();
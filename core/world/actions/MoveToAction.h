@@ -41,9 +41,20 @@ namespace ds {
 		void attach(ID id, ActionSettings* settings);
 		void attach(ID id,const v3& start, const v3& end, float ttl, const tweening::TweeningType& tweeningType = &tweening::easeOutQuad);
 		void update(float dt,ActionEventBuffer& buffer);
+		void materialize();
+		void onTimer(const TimerEvent& e, ActionEventBuffer& buffer);
 		ActionType getActionType() const {
 			return AT_MOVE_TO;
 		}
+		bool writesOnUpdate() const {
+			return _tweenMode == TM_EAGER;
+		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_TYPE);
+		}
+		uint32_t getWriteChannels() const {
+			return WEC_MASK(WEC_POSITION) | WEC_MASK(WEC_ROTATION);
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		void allocate(int sz);
@@ -53,8 +64,9 @@ namespace ds {
 		v3* _start;
 		v3* _end;
 		tweening::TweeningType* _tweeningTypes;
-		float* _timers;
+		float* _startTimes;
 		float* _ttl;
+		float _now;
 	};
 
 }
\ No newline at end of file
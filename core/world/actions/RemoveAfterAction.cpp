@@ -7,14 +7,14 @@ namespace ds {
 	// 
 	// -------------------------------------------------------
 	RemoveAfterAction::RemoveAfterAction(ChannelArray* array, const Rect& boundingRect) : AbstractAction(array, boundingRect, "remove_after") {
-		int sizes[] = { sizeof(ID), sizeof(float), sizeof(float) };
+		int sizes[] = { sizeof(ID), sizeof(TimerHandle), sizeof(float) };
 		_buffer.init(sizes, 3);
 	}
 
 	void RemoveAfterAction::allocate(int sz) {
 		if (_buffer.resize(sz)) {
 			_ids = (ID*)_buffer.get_ptr(0);
-			_timers = (float*)_buffer.get_ptr(1);
+			_handles = (TimerHandle*)_buffer.get_ptr(1);
 			_ttl = (float*)_buffer.get_ptr(2);
 		}
 	}
@@ -22,38 +22,42 @@ namespace ds {
 	// 
 	// -------------------------------------------------------
 	void RemoveAfterAction::attach(ID id, float ttl) {
-		int idx = create(id);
+		int idx = find(id);
+		if (idx != -1) {
+			cancel(_handles[idx]);
+		}
+		idx = create(id);
 		_ids[idx] = id;
-		_timers[idx] = 0.0f;
 		_ttl[idx] = ttl;
+		_handles[idx] = schedule(id, idx, ttl);
 	}
 
 	// -------------------------------------------------------
-	// 
+	// nothing to do here - the timer wheel will call onTimer
 	// -------------------------------------------------------
 	void RemoveAfterAction::update(float dt, ActionEventBuffer& buffer) {
-		if ( _buffer.size > 0 ) {				
-			// move
-			for (uint32_t i = 0; i < _buffer.size; ++i) {
-				_timers[i] += dt;
-				if ( _timers[i] >= _ttl[i] ) {
-					int t = _array->get<int>(_ids[i], WEC_TYPE);
-					buffer.add(_ids[i], AT_KILL, t);
-				}
-			}
+	}
+
+	// -------------------------------------------------------
+	// on timer - the row will be removed along with the entity
+	// -------------------------------------------------------
+	void RemoveAfterAction::onTimer(const TimerEvent& e, ActionEventBuffer& buffer) {
+		if (findTimer(e) != -1) {
+			int t = channels::getType(_array, e.id);
+			buffer.add(e.id, AT_KILL, t);
 		}
 	}
 
 	void RemoveAfterAction::saveReport(const ReportWriter& writer) {
 		if (_buffer.size > 0) {
 			writer.startBox("RemoveAfterAction");
-			const char* OVERVIEW_HEADERS[] = { "ID", "TTL", "Timer" };
+			const char* OVERVIEW_HEADERS[] = { "ID", "TTL", "Remaining" };
 			writer.startTable(OVERVIEW_HEADERS, 3);
 			for (uint32_t i = 0; i < _buffer.size; ++i) {
 				writer.startRow();
 				writer.addCell(_ids[i]);
 				writer.addCell(_ttl[i]);
-				writer.addCell(_timers[i]);
+				writer.addCell(_wheel->remaining(_handles[i]));
 				writer.endRow();
 			}
 			writer.endTable();
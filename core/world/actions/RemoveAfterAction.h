@@ -11,13 +11,19 @@ namespace ds {
 		virtual ~RemoveAfterAction() {}
 		void attach(ID id, float ttl);
 		void update(float dt,ActionEventBuffer& buffer);
+		void onTimer(const TimerEvent& e, ActionEventBuffer& buffer);
 		ActionType getActionType() const {
 			return AT_REMOVE_AFTER;
 		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_TYPE);
+		}
+		uint32_t getWriteChannels() const {
+			return 0;
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		void allocate(int sz);
-		float* _timers;
 		float* _ttl;
 	};
 
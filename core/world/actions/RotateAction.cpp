@@ -1,6 +1,10 @@
 #include "RotateAction.h"
 #include "..\..\log\Log.h"
 #include "..\..\math\GameMath.h"
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DS_ROTATE_SSE
+#include <emmintrin.h>
+#endif
 
 namespace ds {
 	// -------------------------------------------------------
@@ -35,17 +39,49 @@ namespace ds {
 	// -------------------------------------------------------
 	// 
 	// -------------------------------------------------------
+	// -------------------------------------------------------
+	// update - the timers are advanced four rows at a time.
+	// Expired rows are removed backwards so every row swapped
+	// into a removed one was already updated.
+	// -------------------------------------------------------
 	void RotateAction::update(float dt,ActionEventBuffer& buffer) {	
 		if (_buffer.size > 0) {
-			for (uint32_t i = 0; i < _buffer.size; ++i) {
-				v3 r = _array->get<v3>(_ids[i], WEC_ROTATION);
+			uint32_t n = _buffer.size;
+			for (uint32_t i = 0; i < n; ++i) {
+				prefetch(i + ACTION_PREFETCH_DISTANCE, WEC_ROTATION);
+				v3 r = channels::getRotation(_array, _ids[i]);
 				r += _velocities[i] * dt;
-				_array->set<v3>(_ids[i], WEC_ROTATION, r);
+				channels::setRotation(_array, _ids[i], r);
+			}
+			uint32_t i = 0;
+			bool expired = false;
+#ifdef DS_ROTATE_SSE
+			__m128 vdt = _mm_set1_ps(dt);
+			__m128 zero = _mm_setzero_ps();
+			for (; i + 4 <= n; i += 4) {
+				__m128 ttl = _mm_loadu_ps(_ttl + i);
+				__m128 timers = _mm_loadu_ps(_timers + i);
+				__m128 active = _mm_cmpge_ps(ttl, zero);
+				timers = _mm_add_ps(timers, _mm_and_ps(vdt, active));
+				_mm_storeu_ps(_timers + i, timers);
+				if (_mm_movemask_ps(_mm_and_ps(active, _mm_cmpge_ps(timers, ttl))) != 0) {
+					expired = true;
+				}
+			}
+#endif
+			for (; i < n; ++i) {
 				if (_ttl[i] >= 0.0f) {
 					_timers[i] += dt;
 					if (_timers[i] >= _ttl[i]) {
-						buffer.add(_ids[i], AT_ROTATE, _array->get<int>(_ids[i], WEC_TYPE));
-						removeByIndex(i);
+						expired = true;
+					}
+				}
+			}
+			if (expired) {
+				for (int j = n - 1; j >= 0; --j) {
+					if (_ttl[j] >= 0.0f && _timers[j] >= _ttl[j]) {
+						buffer.add(_ids[j], AT_ROTATE, channels::getType(_array, _ids[j]));
+						removeByIndex(j);
 					}
 				}
 			}
@@ -45,14 +45,14 @@ namespace ds {
 		if (_buffer.size > 0) {
 			// move
 			for (uint32_t i = 0; i < _buffer.size; ++i) {
-				v3 r = _array->get<v3>(_ids[i], WEC_ROTATION);
+				v3 r = channels::getRotation(_array, _ids[i]);
 				r.x += _angles[i] * dt;
 				r.y += _angles[i] * dt;
 				r.z += _angles[i] * dt;
-				_array->set<v3>(_ids[i], WEC_ROTATION, r);
+				channels::setRotation(_array, _ids[i], r);
 				_timers[i] += dt;
 				if ( _timers[i] >= _ttl[i] ) {
-					buffer.add(_ids[i], AT_ROTATE_BY, _array->get<int>(_ids[i],WEC_TYPE));
+					buffer.add(_ids[i], AT_ROTATE_BY, channels::getType(_array, _ids[i]));
 					removeByIndex(i);
 				}
 			}
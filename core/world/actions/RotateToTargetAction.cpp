@@ -41,10 +41,10 @@ namespace ds {
 				v3 target = _array->get<v3>(_targets[i], WEC_POSITION);
 				v3 diff = target - current;
 				float angle = math::getAngle(V2_RIGHT, diff.xy());
-				v3 r = _array->get<v3>(_ids[i], WEC_ROTATION);
+				v3 r = channels::getRotation(_array, _ids[i]);
 				float delta = angle - r.x;
 				if ( abs(delta) <= DEGTORAD(5.0f) ) {
-					buffer.add(_ids[i], AT_ROTATE_TO_TARGET, _array->get<int>(_ids[i],WEC_TYPE));
+					buffer.add(_ids[i], AT_ROTATE_TO_TARGET, channels::getType(_array, _ids[i]));
 					removeByIndex(i);
 				}
 				else {										
@@ -60,7 +60,7 @@ namespace ds {
 					if (r.x < 0.0f) {
 						r.x += TWO_PI;
 					}
-					_array->set<v3>(_ids[i], WEC_ROTATION, r);
+					channels::setRotation(_array, _ids[i], r);
 				}
 			}
 		}
@@ -42,7 +42,9 @@ namespace ds {
 		_ttl[idx] = ttl;
 		_tweeningTypes[idx] = tweeningType;
 		_modes[idx] = mode;
-		_array->set(id, WEC_SCALE, startScale);
+		v3 s = channels::getScale(_array, id);
+		s.x = startScale;
+		channels::setScale(_array, id, s);
 		if ( mode > 0 ) {
 			--_modes[idx];
 		}
@@ -57,16 +59,17 @@ namespace ds {
 			// move
 			for (uint32_t i = 0; i < _buffer.size; ++i) {
 				_timers[i] += dt;
-				v3 r = _array->get<v3>(_ids[i], WEC_SCALE);
+				v3 r = channels::getScale(_array, _ids[i]);
 				r.data[_axes[i]] = tweening::interpolate(_tweeningTypes[i], _startScale[i], _endScale[i], _timers[i], _ttl[i]);
-				_array->set(_ids[i], WEC_SCALE, r);				
+				channels::setScale(_array, _ids[i], r);				
 				if ( _timers[i] >= _ttl[i] ) {
 					if ( _modes[i] < 0 ) {
 						_timers[i] = 0.0f;
 					}
 					else if ( _modes[i] == 0 ) {
-						_array->set(_ids[i], WEC_SCALE, _endScale[i]);
-						buffer.add(_ids[i], AT_SCALE_AXES, _array->get<int>(_ids[i],WEC_TYPE));
+						r.x = _endScale[i];
+						channels::setScale(_array, _ids[i], r);
+						buffer.add(_ids[i], AT_SCALE_AXES, channels::getType(_array, _ids[i]));
 						removeByIndex(i);
 					}
 					else {
@@ -17,6 +17,12 @@ namespace ds {
 		ActionType getActionType() const {
 			return AT_SCALE_AXES;
 		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_SCALE) | WEC_MASK(WEC_TYPE);
+		}
+		uint32_t getWriteChannels() const {
+			return WEC_MASK(WEC_SCALE);
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		void allocate(int sz);
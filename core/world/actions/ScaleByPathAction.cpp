@@ -6,9 +6,9 @@ namespace ds {
 	// -------------------------------------------------------
 	// 
 	// -------------------------------------------------------
-	ScaleByPathAction::ScaleByPathAction(ChannelArray* array, const Rect& boundingRect) : AbstractAction(array, boundingRect, "scale_by_path") {
-		int sizes[] = { sizeof(ID), sizeof(V3Path*), sizeof(float), sizeof(float) };
-		_buffer.init(sizes, 4);
+	ScaleByPathAction::ScaleByPathAction(ChannelArray* array, const Rect& boundingRect) : AbstractAction(array, boundingRect, "scale_by_path") , _now(0.0f) {
+		int sizes[] = { sizeof(ID), sizeof(V3Path*), sizeof(float), sizeof(float), sizeof(TimerHandle) };
+		_buffer.init(sizes, 5);
 	}
 
 	// -------------------------------------------------------
@@ -22,8 +22,9 @@ namespace ds {
 		if (_buffer.resize(sz)) {
 			_ids = (ID*)_buffer.get_ptr(0);
 			_path = (V3Path**)_buffer.get_ptr(1);
-			_timers = (float*)_buffer.get_ptr(2);
+			_startTimes = (float*)_buffer.get_ptr(2);
 			_ttl = (float*)_buffer.get_ptr(3);
+			_handles = (TimerHandle*)_buffer.get_ptr(4);
 		}
 	}
 
@@ -40,14 +41,20 @@ namespace ds {
 	// 
 	// -------------------------------------------------------
 	void ScaleByPathAction::attach(ID id, V3Path* path, float ttl) {
-		int idx = create(id);
+		int idx = find(id);
+		if (idx != -1) {
+			cancel(_handles[idx]);
+		}
+		idx = create(id);
 		_ids[idx] = id;
 		_path[idx] = path;
-		v3 s(1, 1, 1);
-		path->get(0.0f, &s);
-		_array->set<v3>(id,WEC_SCALE,s);
-		_timers[idx] = 0.0f;
-		_ttl[idx] = ttl;		
+		if (!path->isBaked()) {
+			path->bake();
+		}
+		channels::setScale(_array, id, path->sample(0.0f));
+		_startTimes[idx] = _now;
+		_ttl[idx] = ttl;
+		_handles[idx] = schedule(id, idx, ttl);
 	}
 	
 	// -------------------------------------------------------
@@ -56,21 +63,30 @@ namespace ds {
 	void ScaleByPathAction::update(float dt, ActionEventBuffer& buffer) {
 		if ( _buffer.size > 0 ) {				
 			// move
-			v3 scale;
 			for (uint32_t i = 0; i < _buffer.size; ++i) {
-				float norm = math::norm(_timers[i], _ttl[i]);
-				_path[i]->get(norm, &scale);
-				_array->set<v3>(_ids[i], WEC_SCALE, scale);
-				_timers[i] += dt;
-				if ( _timers[i] >= _ttl[i] ) {
-					_path[i]->get(1.0f, &scale);
-					_array->set<v3>(_ids[i], WEC_SCALE, scale);
-					int t = _array->get<int>(_ids[i], WEC_TYPE);
-					buffer.add(_ids[i], AT_SCALE_BY_PATH, t);
-					removeByIndex(i);
-				}
+				float norm = math::norm(_now - _startTimes[i], _ttl[i]);
+				channels::setScale(_array, _ids[i], _path[i]->sample(norm));
 			}
+			_now += dt;
+		}
+		else {
+			_now = 0.0f;
+		}
+	}
+
+	// -------------------------------------------------------
+	// on timer - ttl has expired
+	// -------------------------------------------------------
+	void ScaleByPathAction::onTimer(const TimerEvent& e, ActionEventBuffer& buffer) {
+		int i = findTimer(e);
+		if (i == -1) {
+			return;
 		}
+		channels::setScale(_array, e.id, _path[i]->sample(1.0f));
+		markRow(e.id);
+		int t = channels::getType(_array, e.id);
+		buffer.add(e.id, AT_SCALE_BY_PATH, t);
+		removeByIndex(i);
 	}
 	
 	// -------------------------------------------------------
@@ -85,7 +101,7 @@ namespace ds {
 				writer.startRow();
 				writer.addCell(i);
 				writer.addCell(_ids[i]);
-				writer.addCell(_timers[i]);
+				writer.addCell(_now - _startTimes[i]);
 				writer.addCell(_ttl[i]);
 				writer.endRow();
 			}
@@ -35,15 +35,23 @@ namespace ds {
 		void attach(ID id, V3Path* path, float ttl);
 		void attach(ID id, ActionSettings* settings);
 		void update(float dt,ActionEventBuffer& buffer);
+		void onTimer(const TimerEvent& e, ActionEventBuffer& buffer);
 		ActionType getActionType() const {
 			return AT_SCALE_BY_PATH;
 		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_TYPE);
+		}
+		uint32_t getWriteChannels() const {
+			return WEC_MASK(WEC_SCALE);
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		void allocate(int sz);
 		V3Path** _path;
-		float* _timers;
+		float* _startTimes;
 		float* _ttl;
+		float _now;
 	};
 
 }
\ No newline at end of file
@@ -1,14 +1,15 @@
 #include "ScalingAction.h"
 #include "..\..\math\GameMath.h"
 #include "..\..\log\Log.h"
+#include "..\..\math\math.h"
 
 namespace ds {
 	// -------------------------------------------------------
 	// 
 	// -------------------------------------------------------
-	ScalingAction::ScalingAction(ChannelArray* array, const Rect& boundingRect) : AbstractAction(array, boundingRect, "scale") {
-		int sizes[] = { sizeof(ID), sizeof(int), sizeof(v3), sizeof(v3), sizeof(float), sizeof(float), sizeof(tweening::TweeningType), sizeof(int) };
-		_buffer.init(sizes, 8);
+	ScalingAction::ScalingAction(ChannelArray* array, const Rect& boundingRect) : AbstractAction(array, boundingRect, "scale") , _now(0.0f) , _writeChannels(0) {
+		int sizes[] = { sizeof(ID), sizeof(int), sizeof(v3), sizeof(v3), sizeof(float), sizeof(float), sizeof(tweening::TweeningType), sizeof(int), sizeof(TimerHandle) };
+		_buffer.init(sizes, 9);
 	}
 
 	// -------------------------------------------------------
@@ -22,59 +23,87 @@ namespace ds {
 			_channels = (int*)_buffer.get_ptr(1);
 			_startScale = (v3*)_buffer.get_ptr(2);
 			_endScale = (v3*)_buffer.get_ptr(3);
-			_timers = (float*)_buffer.get_ptr(4);
+			_startTimes = (float*)_buffer.get_ptr(4);
 			_ttl = (float*)_buffer.get_ptr(5);
 			_tweeningTypes = (tweening::TweeningType*)_buffer.get_ptr(6);
 			_modes = (int*)_buffer.get_ptr(7);
+			_handles = (TimerHandle*)_buffer.get_ptr(8);
 		}
 	}
 	// -------------------------------------------------------
 	// 
 	// -------------------------------------------------------
 	void ScalingAction::attach(ID id, int channel, const v3& startScale,const v3& endScale,float ttl,int mode,const tweening::TweeningType& tweeningType) {
-		int idx = create(id);
+		int idx = find(id);
+		if (idx != -1) {
+			cancel(_handles[idx]);
+		}
+		_writeChannels |= WEC_MASK(channel);
+		idx = create(id);
 		_ids[idx] = id;
 		_channels[idx] = channel;
 		_startScale[idx] = startScale;
 		_endScale[idx] = endScale;
-		_timers[idx] = 0.0f;
+		_startTimes[idx] = _now;
 		_ttl[idx] = ttl;
 		_tweeningTypes[idx] = tweeningType;
 		_modes[idx] = mode;
-		_array->set(id, channel, startScale);
+		channels::set(_array, id, channel, startScale);
 		if ( mode > 0 ) {
 			--_modes[idx];
 		}
+		_handles[idx] = schedule(id, idx, ttl);
 
 	}
 
 	// -------------------------------------------------------
-	// 
+	// update - advances the clock and writes the values in
+	// TM_EAGER mode
 	// -------------------------------------------------------
 	void ScalingAction::update(float dt,ActionEventBuffer& buffer) {
 		if (_buffer.size > 0) {
-			// move
-			for (uint32_t i = 0; i < _buffer.size; ++i) {
-				_timers[i] += dt;
-				v3 t = tweening::interpolate(_tweeningTypes[i], _startScale[i], _endScale[i], _timers[i], _ttl[i]);
-				_array->set(_ids[i], _channels[i], t);				
-				if ( _timers[i] >= _ttl[i] ) {
-					if ( _modes[i] < 0 ) {
-						_timers[i] = 0.0f;
-					}
-					else if ( _modes[i] == 0 ) {
-						///_array->set(_ids[i], _channels[i], _endScale[i]);
-						buffer.add(_ids[i], AT_SCALE, _array->get<int>(_ids[i],WEC_TYPE));
-						removeByIndex(i);
-					}
-					else {
-						--_modes[i];
-						_timers[i] = 0.0f;
-						//_array->set(_ids[i], _channels[i], _startScale[i]);
+			_now += dt;
+			if (_tweenMode == TM_EAGER) {
+				materialize();
+			}
+		}
+		else {
+			_now = 0.0f;
+			_writeChannels = 0;
+		}
+	}
+
+	// -------------------------------------------------------
+	// materialize - evaluate all rows at the current time
+	// -------------------------------------------------------
+	void ScalingAction::materialize() {
+		for (uint32_t i = 0; i < _buffer.size; ++i) {
+			float elapsed = math::clamp(_now - _startTimes[i], 0.0f, _ttl[i]);
+			v3 t = tweening::interpolate(_tweeningTypes[i], _startScale[i], _endScale[i], elapsed, _ttl[i]);
+			channels::set(_array, _ids[i], _channels[i], t);
+		}
+	}
 
-					}
-				}
+	// -------------------------------------------------------
+	// on timer - restart or finish the row
+	// -------------------------------------------------------
+	void ScalingAction::onTimer(const TimerEvent& e, ActionEventBuffer& buffer) {
+		int i = findTimer(e);
+		if (i == -1) {
+			return;
+		}
+		if (_modes[i] == 0) {
+			channels::set(_array, e.id, _channels[i], tweening::interpolate(_tweeningTypes[i], _startScale[i], _endScale[i], _ttl[i], _ttl[i]));
+			markRow(e.id);
+			buffer.add(e.id, AT_SCALE, channels::getType(_array, e.id));
+			removeByIndex(i);
+		}
+		else {
+			if (_modes[i] > 0) {
+				--_modes[i];
 			}
+			_startTimes[i] = _now;
+			_handles[i] = schedule(e.id, i, _ttl[i]);
 		}
 	}
 
@@ -89,7 +118,7 @@ namespace ds {
 				writer.addCell(_startScale[i]);
 				writer.addCell(_endScale[i]);
 				writer.addCell(_ttl[i]);
-				writer.addCell(_timers[i]);
+				writer.addCell(_now - _startTimes[i]);
 				writer.endRow();
 			}
 			writer.endTable();
@@ -33,18 +33,32 @@ namespace ds {
 		virtual ~ScalingAction();
 		void attach(ID id, int channel, const v3& startScale, const v3& endScale,float ttl,int mode = 0,const tweening::TweeningType& tweeningType = &tweening::easeOutQuad);
 		void update(float dt,ActionEventBuffer& buffer);
+		void materialize();
+		void onTimer(const TimerEvent& e, ActionEventBuffer& buffer);
 		ActionType getActionType() const {
 			return AT_SCALE;
 		}
+		bool writesOnUpdate() const {
+			return _tweenMode == TM_EAGER;
+		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_TYPE);
+		}
+		// the channels of all rows attached since the action was empty
+		uint32_t getWriteChannels() const {
+			return _writeChannels;
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		void allocate(int sz);
 		v3* _startScale;
 		v3* _endScale;
-		float* _timers;
+		float* _startTimes;
 		float* _ttl;
 		tweening::TweeningType* _tweeningTypes;
 		int* _modes;
+		float _now;
+		uint32_t _writeChannels;
 	};
 
 }
\ No newline at end of file
@@ -52,8 +52,15 @@ namespace ds {
 	// 
 	// -------------------------------------------------------
 	void SeekAction::update(float dt,ActionEventBuffer& buffer) {
+		updateChunk(dt, buffer, 0, _buffer.size);
+	}
+
+	// -------------------------------------------------------
+	// update chunk - every row only touches its own entity
+	// -------------------------------------------------------
+	void SeekAction::updateChunk(float dt, ActionEventBuffer& buffer, uint32_t start, uint32_t end) {
 		if (_buffer.size > 0) {
-			for (uint32_t i = 0; i < _buffer.size; ++i) {
+			for (uint32_t i = start; i < end; ++i) {
 				v3 p = _array->get<v3>(_ids[i], WEC_POSITION);
 				v3 t = _array->get<v3>(_targets[i],WEC_POSITION);
 				v3 f = _array->get<v3>(_ids[i], WEC_FORCE);
@@ -63,9 +70,9 @@ namespace ds {
 				v3 desired = n * _velocities[i];
 				f += desired * dt;
 
-				v3 r = _array->get<v3>(_ids[i], WEC_ROTATION);
+				v3 r = channels::getRotation(_array, _ids[i]);
 				r.x = math::getAngle(p.xy(), t.xy());
-				_array->set<v3>(_ids[i], WEC_ROTATION, r);
+				channels::setRotation(_array, _ids[i], r);
 				
 				_array->set<v3>(_ids[i], WEC_FORCE, f);
 			}
@@ -31,9 +31,19 @@ namespace ds {
 		void attach(ID id, ActionSettings* settings);
 		void attach(ID id, ID target, float velocity);
 		void update(float dt,ActionEventBuffer& buffer);
+		bool supportsChunks() const {
+			return true;
+		}
+		void updateChunk(float dt, ActionEventBuffer& buffer, uint32_t start, uint32_t end);
 		ActionType getActionType() const {
 			return AT_SEEK;
 		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_POSITION) | WEC_MASK(WEC_ROTATION) | WEC_MASK(WEC_FORCE) | WEC_MASK(WEC_HASH);
+		}
+		uint32_t getWriteChannels() const {
+			return WEC_MASK(WEC_ROTATION) | WEC_MASK(WEC_FORCE);
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		void allocate(int sz);
@@ -41,7 +41,7 @@ namespace ds {
 		int cnt = 0;
 		for (int i = 0; i < _array->capacity; ++i) {
 			if (indices[i] != -1 && cnt < max) {
-				int t = _array->get<int>(i, WEC_TYPE);
+				int t = channels::getType(_array, i);
 				if (t == type) {
 					ids[cnt++] = i;
 				}
@@ -54,9 +54,17 @@ namespace ds {
 	// 
 	// -------------------------------------------------------
 	void SeparateAction::update(float dt,ActionEventBuffer& buffer) {
+		updateChunk(dt, buffer, 0, _buffer.size);
+	}
+
+	// -------------------------------------------------------
+	// update chunk - the force of a row updated every n 
+	// frames is scaled by n
+	// -------------------------------------------------------
+	void SeparateAction::updateChunk(float dt, ActionEventBuffer& buffer, uint32_t start, uint32_t end) {
 		ID ids[256];
 		if (_buffer.size > 0) {
-			for (uint32_t i = 0; i < _buffer.size; ++i) {
+			for (uint32_t i = start; i < end; ++i) {
 				float sqrDist = _minDistances[i] * _minDistances[i];
 				v3 f = _array->get<v3>(_ids[i], WEC_FORCE);
 				v3 currentPos = _array->get<v3>(_ids[i], WEC_POSITION);
@@ -67,7 +75,7 @@ namespace ds {
 						if (sqr_length(dist) < sqrDist) {
 							v3 separationForce = dist;
 							separationForce = normalize(separationForce);
-							separationForce = separationForce * _relaxations[i];
+							separationForce = separationForce * _relaxations[i] * _steps;
 							f -= separationForce;
 						}
 					}
@@ -39,9 +39,19 @@ namespace ds {
 		void attach(ID id, ActionSettings* settings);
 		void attach(ID id, int type, float minDistance, float relaxation);
 		void update(float dt,ActionEventBuffer& buffer);
+		bool supportsChunks() const {
+			return true;
+		}
+		void updateChunk(float dt, ActionEventBuffer& buffer, uint32_t start, uint32_t end);
 		ActionType getActionType() const {
 			return AT_SEPARATE;
 		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_POSITION) | WEC_MASK(WEC_TYPE) | WEC_MASK(WEC_FORCE);
+		}
+		uint32_t getWriteChannels() const {
+			return WEC_MASK(WEC_FORCE);
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		int find_by_type(int type, ID* ids, int max) const;
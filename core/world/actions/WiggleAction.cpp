@@ -7,8 +7,8 @@ namespace ds {
 	// -------------------------------------------------------
 	// 
 	// -------------------------------------------------------
-	WiggleAction::WiggleAction(ChannelArray* array, const Rect& boundingRect) : AbstractAction(array, boundingRect, "wiggle") {
-		int sizes[] = { sizeof(ID), sizeof(float), sizeof(float), sizeof(float), sizeof(float)};
+	WiggleAction::WiggleAction(ChannelArray* array, const Rect& boundingRect) : AbstractAction(array, boundingRect, "wiggle") , _now(0.0f) {
+		int sizes[] = { sizeof(ID), sizeof(float), sizeof(float), sizeof(float), sizeof(TimerHandle)};
 		_buffer.init(sizes, 5);
 	}
 
@@ -17,8 +17,8 @@ namespace ds {
 			_ids = (ID*)_buffer.get_ptr(0);
 			_amplitudes = (float*)_buffer.get_ptr(1);
 			_frequencies = (float*)_buffer.get_ptr(2);
-			_timers = (float*)_buffer.get_ptr(3);
-			_ttl = (float*)_buffer.get_ptr(4);
+			_startTimes = (float*)_buffer.get_ptr(3);
+			_handles = (TimerHandle*)_buffer.get_ptr(4);
 		}
 	}
 
@@ -31,12 +31,19 @@ namespace ds {
 	// 
 	// -------------------------------------------------------
 	void WiggleAction::attach(ID id, float amplitude, float frequency, float ttl) {
-		int idx = create(id);
+		int idx = find(id);
+		if (idx != -1) {
+			cancel(_handles[idx]);
+		}
+		idx = create(id);
 		_ids[idx] = id;
 		_amplitudes[idx] = amplitude;
 		_frequencies[idx] = frequency;
-		_timers[idx] = 0.0f;
-		_ttl[idx] = ttl;
+		_startTimes[idx] = _now;
+		_handles[idx] = INVALID_TIMER;
+		if (ttl > 0.0f) {
+			_handles[idx] = schedule(id, idx, ttl);
+		}
 	}
 	
 	// -------------------------------------------------------
@@ -44,25 +51,35 @@ namespace ds {
 	// -------------------------------------------------------
 	void WiggleAction::update(float dt, ActionEventBuffer& buffer) {
 		if (_buffer.size > 0) {
-			for (int i = 0; i < _buffer.size; ++i) {
-				_timers[i] += dt;
+			_now += dt;
+			for (uint32_t i = 0; i < _buffer.size; ++i) {
+				float timer = _now - _startTimes[i];
 				v3 p = _array->get<v3>(_ids[i],WEC_FORCE);
-				v3 r = _array->get<v3>(_ids[i], WEC_ROTATION);
+				v3 r = channels::getRotation(_array, _ids[i]);
 				float angle = r.x + DEGTORAD(90.0f);
-				float x = angle + cos(_timers[i] * _frequencies[i]) * _amplitudes[i];
-				float y = angle + sin(_timers[i] * _frequencies[i]) * _amplitudes[i];
+				float x = angle + cos(timer * _frequencies[i]) * _amplitudes[i];
+				float y = angle + sin(timer * _frequencies[i]) * _amplitudes[i];
 				v3 add = v3(x, y, 0.0f);
 				p += add * dt;
-				if (_ttl[i] > 0.0f) {
-					if (_timers[i] >= _ttl[i]) {
-						int t = _array->get<int>(_ids[i], WEC_TYPE);
-						buffer.add(_ids[i], AT_WIGGLE, t);
-						removeByIndex(i);
-					}
-				}
 				_array->set<v3>(_ids[i],WEC_FORCE, p);
 			}
 		}
+		else {
+			_now = 0.0f;
+		}
+	}
+
+	// -------------------------------------------------------
+	// on timer - ttl has expired
+	// -------------------------------------------------------
+	void WiggleAction::onTimer(const TimerEvent& e, ActionEventBuffer& buffer) {
+		int i = findTimer(e);
+		if (i == -1) {
+			return;
+		}
+		int t = channels::getType(_array, e.id);
+		buffer.add(e.id, AT_WIGGLE, t);
+		removeByIndex(i);
 	}
 	
 	// -------------------------------------------------------
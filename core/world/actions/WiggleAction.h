@@ -38,17 +38,24 @@ namespace ds {
 		void attach(ID id, ActionSettings* settings);
 		void attach(ID id,float amplitude, float frequency ,float ttl = -1.0f);
 		void update(float dt,ActionEventBuffer& buffer);
+		void onTimer(const TimerEvent& e, ActionEventBuffer& buffer);
 		ActionType getActionType() const {
 			return AT_WIGGLE;
 		}
+		uint32_t getReadChannels() const {
+			return WEC_MASK(WEC_ROTATION) | WEC_MASK(WEC_TYPE) | WEC_MASK(WEC_FORCE);
+		}
+		uint32_t getWriteChannels() const {
+			return WEC_MASK(WEC_FORCE);
+		}
 		void saveReport(const ReportWriter& writer);
 	private:
 		void allocate(int sz);
 
 		float* _amplitudes;
 		float* _frequencies;
-		float* _timers;
-		float* _ttl;
+		float* _startTimes;
+		float _now;
 	};
 
 }
\ No newline at end of file